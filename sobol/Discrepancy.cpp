@@ -0,0 +1,319 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "Discrepancy.h"
+
+using namespace std;
+
+namespace {
+	struct WeightedPoint {
+		size_t index;
+		double weight;
+	};
+
+	typedef vector<WeightedPoint> WeightedPoints;
+
+	// Sum over the pairs (i, j) of A x B of w_i * w_j * prod over the coordinates k of f_k(i, j), where
+	// f_k(i, j) = min(u[k][i], u[k][j]), except for the coordinates split in two sides: there f_k(i, j) = 1 for points
+	// on different sides.
+	class PairSum {
+	public:
+		PairSum(const vector<vector<double>>& u, const vector<vector<bool>>& sides)
+			: u(u), sides(sides) {
+		}
+
+		// coordinates are the coordinates left in the product, sides[side] onwards the side splits left to do.
+		double Sum(const WeightedPoints& a, const WeightedPoints& b, const vector<unsigned short>& coordinates, size_t side, unsigned int threads) const;
+
+	private:
+		struct Branch {
+			WeightedPoints a, b;
+			vector<unsigned short> coordinates;
+			size_t side;
+			double sum;
+		};
+
+		// Cost of a step of the divide and conquer relative to the product of one coordinate of a pair.
+		static const unsigned int splitCost = 8;
+		// Below this many points a branch is not worth a thread.
+		static const size_t parallelPoints = 1 << 14;
+
+		double SumBranches(Branch *branches, unsigned int count, unsigned int threads) const;
+		// The single coordinate case, by sorting: min(x, y) summed over y is x times the weight of the y above x plus
+		// the weighted sum of the y below it.
+		double SumOneCoordinate(const WeightedPoints& a, const WeightedPoints& b, unsigned short k) const;
+		// The divide and conquer takes about (|A| + |B|) log^(m - 1) steps for m coordinates, which in many dimensions
+		// is more than summing the |A| |B| m products directly.
+		static bool IsBruteForceCheaper(size_t aSize, size_t bSize, size_t coordinates);
+		double SumPairs(const WeightedPoints& a, const WeightedPoints& b, const vector<unsigned short>& coordinates) const;
+
+		const vector<vector<double>>& u;
+		const vector<vector<bool>>& sides;
+	};
+
+	double SumWeights(const WeightedPoints& points) {
+		double sum = 0.0;
+		for (auto it = points.begin(); it != points.end(); ++it) {
+			sum += it->weight;
+		}
+		return sum;
+	}
+
+	double PairSum::Sum(const WeightedPoints& a, const WeightedPoints& b, const vector<unsigned short>& coordinates, size_t side, unsigned int threads) const {
+		if (a.empty() || b.empty()) {
+			return 0.0;
+		}
+
+		Branch branches[4];
+		if (side < sides.size()) {
+			// Pairs on different sides of coordinate side drop it, pairs on the same side keep it.
+			const vector<bool>& sideOf = sides[side];
+			WeightedPoints aSides[2], bSides[2];
+			for (auto it = a.begin(); it != a.end(); ++it) {
+				aSides[sideOf[it->index]].push_back(*it);
+			}
+			for (auto it = b.begin(); it != b.end(); ++it) {
+				bSides[sideOf[it->index]].push_back(*it);
+			}
+			vector<unsigned short> kept(coordinates);
+			kept.push_back((unsigned short)side);
+			// Every side takes part in two branches, the second one can have it.
+			for (unsigned int i = 0; i < 4; ++i) {
+				branches[i].a = i >> 1 ? move(aSides[i & 1]) : aSides[i & 1];
+				branches[i].b = i >> 1 ? move(bSides[(i & 1) ^ 1]) : bSides[i & 1];
+				branches[i].coordinates = i >> 1 ? coordinates : kept;
+				branches[i].side = side + 1;
+			}
+			return SumBranches(branches, 4, threads);
+		}
+
+		if (coordinates.empty()) {
+			return SumWeights(a) * SumWeights(b);
+		}
+		if (1 == coordinates.size()) {
+			return SumOneCoordinate(a, b, coordinates[0]);
+		}
+		if (IsBruteForceCheaper(a.size(), b.size(), coordinates.size())) {
+			return SumPairs(a, b, coordinates);
+		}
+
+		const unsigned short k = coordinates.back();
+		const vector<double>& uk = u[k];
+		vector<unsigned short> rest(coordinates.begin(), coordinates.end() - 1);
+		vector<double> values;
+		values.reserve(a.size() + b.size());
+		for (auto it = a.begin(); it != a.end(); ++it) {
+			values.push_back(uk[it->index]);
+		}
+		for (auto it = b.begin(); it != b.end(); ++it) {
+			values.push_back(uk[it->index]);
+		}
+		nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+		const double median = values[values.size() / 2];
+		const double highest = *max_element(values.begin() + values.size() / 2, values.end());
+		if (highest == median && *min_element(values.begin(), values.begin() + values.size() / 2 + 1) == median) {
+			// All equal, every pair has median as minimum.
+			WeightedPoints folded(a);
+			for (auto it = folded.begin(); it != folded.end(); ++it) {
+				it->weight *= median;
+			}
+			return Sum(folded, b, rest, side, threads);
+		}
+
+		// The median goes low, unless it is the highest value: then low is below the median. Both halves are non
+		// empty either way, and a low point is below every high one.
+		WeightedPoints aHalves[2], bHalves[2];
+		for (auto it = a.begin(); it != a.end(); ++it) {
+			aHalves[highest == median ? uk[it->index] >= median : uk[it->index] > median].push_back(*it);
+		}
+		for (auto it = b.begin(); it != b.end(); ++it) {
+			bHalves[highest == median ? uk[it->index] >= median : uk[it->index] > median].push_back(*it);
+		}
+
+		// Low with low and high with high still depend on coordinate k, across the halves its minimum is the low point.
+		branches[2].a = aHalves[0];
+		branches[2].b = bHalves[1];
+		branches[3].a = bHalves[0];
+		branches[3].b = aHalves[1];
+		for (unsigned int i = 0; i < 2; ++i) {
+			branches[i].a = move(aHalves[i]);
+			branches[i].b = move(bHalves[i]);
+			branches[i].coordinates = coordinates;
+			branches[i].side = side;
+		}
+		for (unsigned int i = 2; i < 4; ++i) {
+			for (auto it = branches[i].a.begin(); it != branches[i].a.end(); ++it) {
+				it->weight *= uk[it->index];
+			}
+			branches[i].coordinates = rest;
+			branches[i].side = side;
+		}
+		return SumBranches(branches, 4, threads);
+	}
+
+	double PairSum::SumBranches(Branch *branches, unsigned int count, unsigned int threads) const {
+		size_t points = 0;
+		for (unsigned int i = 0; i < count; ++i) {
+			points += branches[i].a.size() + branches[i].b.size();
+		}
+		const unsigned int workers = points < parallelPoints ? 1 : min(threads, count);
+		auto sumBranches = [&](unsigned int worker) {
+			for (unsigned int i = worker; i < count; i += workers) {
+				branches[i].sum = Sum(branches[i].a, branches[i].b, branches[i].coordinates, branches[i].side, threads / workers);
+			}
+		};
+
+		vector<thread> pool;
+		for (unsigned int worker = 1; worker < workers; ++worker) {
+			pool.push_back(thread(sumBranches, worker));
+		}
+		sumBranches(0);
+		for (auto it = pool.begin(); it != pool.end(); ++it) {
+			it->join();
+		}
+
+		double sum = 0.0;
+		for (unsigned int i = 0; i < count; ++i) {
+			sum += branches[i].sum;
+		}
+		return sum;
+	}
+
+	double PairSum::SumOneCoordinate(const WeightedPoints& a, const WeightedPoints& b, unsigned short k) const {
+		const vector<double>& uk = u[k];
+		vector<pair<double, double>> sortedA, sortedB;
+		sortedA.reserve(a.size());
+		sortedB.reserve(b.size());
+		for (auto it = a.begin(); it != a.end(); ++it) {
+			sortedA.push_back(make_pair(uk[it->index], it->weight));
+		}
+		for (auto it = b.begin(); it != b.end(); ++it) {
+			sortedB.push_back(make_pair(uk[it->index], it->weight));
+		}
+		sort(sortedA.begin(), sortedA.end());
+		sort(sortedB.begin(), sortedB.end());
+
+		const double weightB = SumWeights(b);
+		double sum = 0.0, lowWeight = 0.0, lowSum = 0.0;
+		auto low = sortedB.begin();
+		for (auto it = sortedA.begin(); it != sortedA.end(); ++it) {
+			for (; sortedB.end() != low && low->first < it->first; ++low) {
+				lowWeight += low->second;
+				lowSum += low->second * low->first;
+			}
+			sum += it->second * (it->first * (weightB - lowWeight) + lowSum);
+		}
+		return sum;
+	}
+
+	bool PairSum::IsBruteForceCheaper(size_t aSize, size_t bSize, size_t coordinates) {
+		const double points = (double)(aSize + bSize);
+		return (double)aSize * (double)bSize * coordinates <= splitCost * points * pow(log2(points), (double)(coordinates - 1));
+	}
+
+	double PairSum::SumPairs(const WeightedPoints& a, const WeightedPoints& b, const vector<unsigned short>& coordinates) const {
+		// Gathers the coordinates of B point by point, so that the inner loop runs over contiguous memory.
+		const size_t m = coordinates.size();
+		vector<double> rowsB(b.size() * m), rowA(m);
+		for (size_t j = 0; j < b.size(); ++j) {
+			for (size_t k = 0; k < m; ++k) {
+				rowsB[j * m + k] = u[coordinates[k]][b[j].index];
+			}
+		}
+
+		double sum = 0.0;
+		for (auto i = a.begin(); i != a.end(); ++i) {
+			for (size_t k = 0; k < m; ++k) {
+				rowA[k] = u[coordinates[k]][i->index];
+			}
+			double sumB = 0.0;
+			const double *rowB = rowsB.data();
+			for (auto j = b.begin(); j != b.end(); ++j, rowB += m) {
+				double product = j->weight;
+				for (size_t k = 0; k < m; ++k) {
+					product *= min(rowA[k], rowB[k]);
+				}
+				sumB += product;
+			}
+			sum += i->weight * sumB;
+		}
+		return sum;
+	}
+
+	// Sums the pair product of PairSum over every pair of points, (i, i) and both (i, j) and (j, i) included.
+	double SumAllPairs(const vector<vector<double>>& u, const vector<vector<bool>>& sides, size_t count, unsigned int threads) {
+		if (0 == threads) {
+			threads = thread::hardware_concurrency();
+		}
+		WeightedPoints all(count);
+		for (size_t i = 0; i < count; ++i) {
+			all[i].index = i;
+			all[i].weight = 1.0;
+		}
+		vector<unsigned short> coordinates;
+		if (sides.empty()) {
+			for (unsigned short k = 0; k < u.size(); ++k) {
+				coordinates.push_back(k);
+			}
+		}
+		return PairSum(u, sides).Sum(all, all, coordinates, 0, 0 == threads ? 1 : threads);
+	}
+}
+
+double L2StarDiscrepancy(const double *points, size_t count, unsigned short dimensions, unsigned int threads) {
+	if (0 == count || 0 == dimensions) {
+		return 0.0;
+	}
+
+	// D^2 = 3^-d - 2^(1-d) / N sum_i prod_k (1 - x_ik^2) + 1 / N^2 sum_i,j prod_k (1 - max(x_ik, x_jk))
+	// and 1 - max(x, y) = min(1 - x, 1 - y).
+	vector<vector<double>> u(dimensions, vector<double>(count));
+	double single = 0.0;
+	for (size_t i = 0; i < count; ++i) {
+		double product = 1.0;
+		for (unsigned short k = 0; k < dimensions; ++k) {
+			const double x = points[i * dimensions + k];
+			u[k][i] = 1.0 - x;
+			product *= 1.0 - x * x;
+		}
+		single += product;
+	}
+
+	const double n = (double)count;
+	const double pairs = SumAllPairs(u, vector<vector<bool>>(), count, threads);
+	const double squared = pow(3.0, -(double)dimensions) - pow(2.0, 1.0 - dimensions) * single / n + pairs / (n * n);
+	return sqrt(max(0.0, squared));
+}
+
+double CenteredL2Discrepancy(const double *points, size_t count, unsigned short dimensions, unsigned int threads) {
+	if (0 == count || 0 == dimensions) {
+		return 0.0;
+	}
+
+	// D^2 = (13/12)^d - 2 / N sum_i prod_k (1 + |x_ik - 1/2| / 2 - |x_ik - 1/2|^2 / 2)
+	//     + 1 / N^2 sum_i,j prod_k (1 + |x_ik - 1/2| / 2 + |x_jk - 1/2| / 2 - |x_ik - x_jk| / 2)
+	// With a = |x - 1/2| and b = |y - 1/2|, the factor of the pair is 1 + min(a, b) = min(1 + a, 1 + b) when x and y
+	// are on the same side of 1/2, and 1 otherwise.
+	vector<vector<double>> u(dimensions, vector<double>(count));
+	vector<vector<bool>> sides(dimensions, vector<bool>(count));
+	double single = 0.0;
+	for (size_t i = 0; i < count; ++i) {
+		double product = 1.0;
+		for (unsigned short k = 0; k < dimensions; ++k) {
+			const double x = points[i * dimensions + k];
+			const double a = fabs(x - 0.5);
+			u[k][i] = 1.0 + a;
+			sides[k][i] = x >= 0.5;
+			product *= 1.0 + 0.5 * a - 0.5 * a * a;
+		}
+		single += product;
+	}
+
+	const double n = (double)count;
+	const double pairs = SumAllPairs(u, sides, count, threads);
+	const double squared = pow(13.0 / 12.0, (double)dimensions) - 2.0 * single / n + pairs / (n * n);
+	return sqrt(max(0.0, squared));
+}
\ No newline at end of file
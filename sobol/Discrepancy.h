@@ -0,0 +1,29 @@
+#pragma once
+
+#ifndef DISCREPANCY_H
+#define DISCREPANCY_H
+
+#include <cstddef>
+
+// Uniformity measures of a point set of the unit cube, for comparing samplers, site counts and scramblings at
+// production sizes. points holds count points laid out point-major, as BasicSobolGenerator::GetBlock writes them,
+// with coordinates in [0, 1].
+// Both are closed forms with a double sum over all the pairs of points, which a divide and conquer after Heinrich,
+// "Efficient algorithms for computing the L2-discrepancy" (1996), evaluates instead of in O(N^2 D): the pairs are
+// split on the median of one coordinate at a time, and for the pairs across the split the minimum of that coordinate
+// is known, so it folds into a weight and the coordinate drops out. This version partitions and sorts again at every
+// level, so it runs in O(N log^D N), a log factor above the O(N log^(D - 1) N) of Heinrich's algorithm. log^D N
+// overtakes N quickly as D grows: branches where the direct sum is cheaper fall back to it, so in more than a few
+// dimensions the cost tends to O(N^2 D). The independent halves run on up to threads threads, 0 uses one per
+// hardware thread.
+// The results are accurate to a few digits only for large sets in many dimensions, where the squared discrepancy
+// is a small difference of terms close to 3^-D.
+
+// The L2 star discrepancy, with Warnock's formula: the L2 norm over the anchored boxes [0, y) of the difference between
+// the fraction of points in the box and its volume.
+double L2StarDiscrepancy(const double *points, size_t count, unsigned short dimensions, unsigned int threads = 0);
+// The centered L2 discrepancy of Hickernell, with boxes anchored at the nearest corner of the cube instead of 0, so
+// that it does not depend on which corner is the origin.
+double CenteredL2Discrepancy(const double *points, size_t count, unsigned short dimensions, unsigned int threads = 0);
+
+#endif //DISCREPANCY_H
\ No newline at end of file
@@ -0,0 +1,171 @@
+#pragma once
+
+#ifndef FIXED_SOBOL_GENERATOR_H
+#define FIXED_SOBOL_GENERATOR_H
+
+#include <array>
+#include "SobolGenerator.h"
+
+// Per-dimension steps of FixedSobolGenerator, unrolled at compile time over J = 0 .. D - 1.
+template <unsigned short J, unsigned short D>
+struct FixedSobolUnroll {
+	template <typename Word>
+	static void XorToUnit(Word *X, const Word *directionRow, double *point) {
+		X[J] ^= directionRow[J];
+		point[J] = SobolWord<Word>::ToUnit(X[J]);
+		FixedSobolUnroll<J + 1, D>::XorToUnit(X, directionRow, point);
+	}
+
+	template <typename Word>
+	static void Xor(Word *X, const Word *directionRow) {
+		X[J] ^= directionRow[J];
+		FixedSobolUnroll<J + 1, D>::Xor(X, directionRow);
+	}
+
+	template <typename Word>
+	static void ToUnit(const Word *X, double *point) {
+		point[J] = SobolWord<Word>::ToUnit(X[J]);
+		FixedSobolUnroll<J + 1, D>::ToUnit(X, point);
+	}
+};
+
+template <unsigned short D>
+struct FixedSobolUnroll<D, D> {
+	template <typename Word>
+	static void XorToUnit(Word *, const Word *, double *) {}
+	template <typename Word>
+	static void Xor(Word *, const Word *) {}
+	template <typename Word>
+	static void ToUnit(const Word *, double *) {}
+};
+
+// Sobol generator with the number of dimensions fixed at compile time: the state and direction numbers are plain
+// member arrays sized by D and the word, so there is no allocation at all, and the dimension loop is unrolled.
+// Produces the same points as BasicSobolGenerator<Word>(maxGenerating, D).
+template <unsigned short D, typename Word = uint32_t>
+class FixedSobolGenerator {
+public:
+	static const unsigned short Dimensions = D;
+	static const unsigned int Bits = SobolWord<Word>::Bits;
+	typedef array<double, D> Point;
+
+	explicit FixedSobolGenerator(Word maxGenerating, const DirectionSet& directionSet = globalNewJoeKuo621201) {
+		this->maxGenerating = maxGenerating;
+		requiredBits = 0;
+		for (Word last = 1 < maxGenerating ? maxGenerating - 1 : 0; 0 != last; last >>= 1) {
+			++requiredBits;
+		}
+
+		for (unsigned short j = 0; j < D; ++j) {
+			V[0][j] = 0;
+			ComputeDirectionNumbers(directionSet, j + 1, requiredBits, &V[0][j], D);
+			previousXByDimension[j] = 0;
+			scrambleKeys[j] = 0;
+		}
+
+		scrambling = SobolScrambling::None;
+		previousC = 1;
+		currentGenerating = 0;
+	}
+
+	Word GetMaxGenerating() const { return maxGenerating; }
+
+	// Same as BasicSobolGenerator::Scramble.
+	void Scramble(SobolScrambling scrambling, uint64_t seed = 0) {
+		this->scrambling = scrambling;
+		for (unsigned short j = 0; j < D; ++j) {
+			scrambleKeys[j] = SobolScrambling::None == scrambling ? 0 : SobolScrambleKey<Word>(seed, j);
+		}
+	}
+
+	bool GetNext(Point& point) {
+		if (currentGenerating == maxGenerating) {
+			return false;
+		}
+
+		if (0 == currentGenerating) {
+			ToUnit(previousXByDimension, point.data());
+			++currentGenerating;
+			return true;
+		}
+
+		if (SobolScrambling::None == scrambling) {
+			FixedSobolUnroll<0, D>::XorToUnit(previousXByDimension, V[previousC], point.data());
+		}
+		else {
+			FixedSobolUnroll<0, D>::Xor(previousXByDimension, V[previousC]);
+			ToUnit(previousXByDimension, point.data());
+		}
+		previousC = SobolRightmostZeroBit(currentGenerating);
+		++currentGenerating;
+		return true;
+	}
+
+	// Same as BasicSobolGenerator::Seek.
+	bool Seek(Word index) {
+		if (index > maxGenerating) {
+			return false;
+		}
+
+		currentGenerating = index;
+		previousC = 1;
+		XorGrayCode(0 == index ? 0 : index - 1, previousXByDimension);
+		if (0 != index) {
+			previousC = SobolRightmostZeroBit(index - 1);
+		}
+		return true;
+	}
+
+	// Same as BasicSobolGenerator::PointAt.
+	bool PointAt(Word index, Point& point) const {
+		if (index >= maxGenerating) {
+			return false;
+		}
+
+		Word X[D];
+		XorGrayCode(index, X);
+		ToUnit(X, point.data());
+		return true;
+	}
+
+private:
+	void ToUnit(const Word *X, double *point) const {
+		if (SobolScrambling::None == scrambling) {
+			FixedSobolUnroll<0, D>::ToUnit(X, point);
+			return;
+		}
+		for (unsigned short j = 0; j < D; ++j) {
+			point[j] = SobolWord<Word>::ToUnit(SobolScramble(scrambling, X[j], scrambleKeys[j]));
+		}
+	}
+
+	// X = the XOR of V[i] for every bit i set in the Gray code of index, that is the point at index.
+	void XorGrayCode(Word index, Word *X) const {
+		for (unsigned short j = 0; j < D; ++j) {
+			X[j] = 0;
+		}
+		Word grayCode = index ^ (index >> 1);
+		for (unsigned int i = 1; 0 != grayCode; ++i, grayCode >>= 1) {
+			if (grayCode & 1) {
+				FixedSobolUnroll<0, D>::Xor(X, V[i]);
+			}
+		}
+	}
+
+	Word maxGenerating, currentGenerating;
+	unsigned int requiredBits, previousC;
+	// V[i][j] is V[i] of dimension j + 1, as the bit-major matrix of BasicSobolGenerator.
+	Word V[Bits + 1][D];
+	Word previousXByDimension[D];
+	SobolScrambling scrambling;
+	Word scrambleKeys[D];
+};
+
+// The dimensions the map generators sample in, compiled once in FixedSobolGenerator.cpp.
+extern template class FixedSobolGenerator<2>;
+extern template class FixedSobolGenerator<3>;
+
+typedef FixedSobolGenerator<2> SobolGenerator2D;
+typedef FixedSobolGenerator<3> SobolGenerator3D;
+
+#endif //FIXED_SOBOL_GENERATOR_H
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+
+// Memory mapping of a whole file, on Windows and POSIX systems. Pages are only read from disk when they are first
+// touched, and written back by the system when the file is a writable one made by Create.
+class MappedFile {
+public:
+	MappedFile();
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Maps the file at path, unmapping any previous one. Returns false if it cannot be opened or mapped.
+	// With randomAccess the system is told not to read ahead around touched pages, for files of which only a few
+	// scattered pieces are used.
+	bool Open(const char *path, bool randomAccess = false);
+	// Creates, or truncates, the file at path with size bytes and maps it for writing, unmapping any previous one.
+	// Returns false if it cannot be created, sized or mapped.
+	bool Create(const char *path, size_t size);
+	// Writes the pages of a file made by Create back to disk and waits for them, so that the file can be renamed into
+	// place knowing that its content is durable. Returns false if the file is not writable or cannot be flushed.
+	bool Flush();
+	void Close();
+
+	// Renames the file at from to to, atomically replacing any file already there: other processes see either the
+	// old file or the new one in full, and keep the old one if they have it open. Returns false if it cannot be
+	// renamed, for instance on Windows while the file at to is mapped.
+	static bool Replace(const char *from, const char *to);
+
+	const void *GetData() const { return data; }
+	// The data of a file made by Create, nullptr for a read-only one.
+	void *GetWritableData() const { return writable ? const_cast<void *>(data) : nullptr; }
+	size_t GetSize() const { return size; }
+	bool IsOpen() const { return nullptr != data; }
+
+private:
+	const void *data;
+	size_t size;
+	bool writable;
+#ifdef _WIN32
+	void *fileHandle, *mappingHandle;
+#endif
+};
+
+#endif //MAPPED_FILE_H
\ No newline at end of file
@@ -0,0 +1,269 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include "FixedSobolGenerator.h"
+#include "SiteSampler.h"
+
+namespace {
+	const double pi = 3.14159265358979323846;
+
+	// Uniform in [0, 1) from the 53 high bits, the same on every standard library unlike uniform_real_distribution.
+	double ToUniform(uint64_t bits) {
+		return (double)(bits >> 11) / 9007199254740992.0;
+	}
+
+	// A max-heap of indices ordered by weights, which can change while they are in the heap.
+	class IndexedHeap {
+	public:
+		IndexedHeap(const vector<double>& weights)
+			: weights(weights), heap(weights.size()), positions(weights.size()) {
+			for (uint32_t i = 0; i < heap.size(); ++i) {
+				heap[i] = i;
+				positions[i] = i;
+			}
+			for (size_t i = heap.size() / 2; 0 < i--; ) {
+				SiftDown(i);
+			}
+		}
+
+		uint32_t Pop() {
+			const uint32_t top = heap[0];
+			Swap(0, heap.size() - 1);
+			heap.pop_back();
+			if (!heap.empty()) {
+				SiftDown(0);
+			}
+			return top;
+		}
+
+		// After the weight of index went down.
+		void Decreased(uint32_t index) {
+			SiftDown(positions[index]);
+		}
+
+	private:
+		void SiftDown(size_t position) {
+			for (;;) {
+				size_t largest = position;
+				const size_t left = 2 * position + 1, right = left + 1;
+				if (left < heap.size() && weights[heap[left]] > weights[heap[largest]]) {
+					largest = left;
+				}
+				if (right < heap.size() && weights[heap[right]] > weights[heap[largest]]) {
+					largest = right;
+				}
+				if (largest == position) {
+					return;
+				}
+				Swap(position, largest);
+				position = largest;
+			}
+		}
+
+		void Swap(size_t a, size_t b) {
+			swap(heap[a], heap[b]);
+			positions[heap[a]] = (uint32_t)a;
+			positions[heap[b]] = (uint32_t)b;
+		}
+
+		const vector<double>& weights;
+		vector<uint32_t> heap, positions;
+	};
+}
+
+SobolSiteSampler::SobolSiteSampler(SobolCache *cache)
+	: cache(cache) {
+}
+
+uint32_t SobolSiteSampler::Sample(double width, double height, uint32_t count, uint64_t seed, vector<double>& sites) {
+	const SobolScrambling scrambling = 0 != seed ? SobolScrambling::Owen : SobolScrambling::None;
+	SobolCacheEntry entry;
+	if (nullptr != cache && cache->Get(SobolCacheKey(count, 2, SobolCacheOutput::Double, scrambling, seed), entry)) {
+		sites.assign(entry.GetDoubles(), entry.GetDoubles() + (size_t)entry.GetCount() * 2);
+		for (size_t i = 0; i < sites.size(); i += 2) {
+			sites[i] *= width;
+			sites[i + 1] *= height;
+		}
+		return (uint32_t)(sites.size() / 2);
+	}
+
+	// The fixed dimension generator keeps its state inline and the points on the stack, nothing allocates per point.
+	SobolGenerator2D generator(count);
+	if (SobolScrambling::None != scrambling) {
+		generator.Scramble(scrambling, seed);
+	}
+	sites.clear();
+	sites.reserve((size_t)count * 2);
+	SobolGenerator2D::Point point;
+	while (generator.GetNext(point)) {
+		sites.push_back(point[0] * width);
+		sites.push_back(point[1] * height);
+	}
+	return (uint32_t)(sites.size() / 2);
+}
+
+PoissonDiskSiteSampler::PoissonDiskSiteSampler(double minimumDistance, unsigned int attempts)
+	: minimumDistance(minimumDistance), attempts(attempts) {
+}
+
+double PoissonDiskSiteSampler::GetMinimumDistance(double width, double height, uint32_t count) const {
+	if (0.0 < minimumDistance || 0 == count) {
+		return minimumDistance;
+	}
+	// A full map at distance r holds about 0.62 * area / r^2 sites with 30 attempts.
+	return sqrt(0.62 * width * height / count);
+}
+
+uint32_t PoissonDiskSiteSampler::Sample(double width, double height, uint32_t count, uint64_t seed, vector<double>& sites) {
+	sites.clear();
+	const double distance = GetMinimumDistance(width, height, count);
+	if (!(0.0 < width && 0.0 < height && 0.0 < distance)) {
+		return 0;
+	}
+
+	const double cellSize = distance / sqrt(2.0);
+	const size_t columns = (size_t)ceil(width / cellSize), rows = (size_t)ceil(height / cellSize);
+	const uint32_t empty = ~0u;
+	vector<uint32_t> grid(columns * rows, empty);
+	vector<uint32_t> active;
+	mt19937_64 random(seed);
+
+	auto insert = [&](double x, double y) {
+		const uint32_t site = (uint32_t)(sites.size() / 2);
+		sites.push_back(x);
+		sites.push_back(y);
+		grid[min((size_t)(y / cellSize), rows - 1) * columns + min((size_t)(x / cellSize), columns - 1)] = site;
+		active.push_back(site);
+	};
+	auto isFree = [&](double x, double y) {
+		const size_t column = min((size_t)(x / cellSize), columns - 1), row = min((size_t)(y / cellSize), rows - 1);
+		for (size_t neighbourRow = row < 2 ? 0 : row - 2; neighbourRow <= row + 2 && neighbourRow < rows; ++neighbourRow) {
+			for (size_t neighbourColumn = column < 2 ? 0 : column - 2; neighbourColumn <= column + 2 && neighbourColumn < columns; ++neighbourColumn) {
+				const uint32_t site = grid[neighbourRow * columns + neighbourColumn];
+				if (empty != site) {
+					const double dx = sites[2 * site] - x, dy = sites[2 * site + 1] - y;
+					if (dx * dx + dy * dy < distance * distance) {
+						return false;
+					}
+				}
+			}
+		}
+		return true;
+	};
+
+	insert(ToUniform(random()) * width, ToUniform(random()) * height);
+	while (!active.empty()) {
+		const size_t picked = (size_t)(ToUniform(random()) * active.size());
+		const double x = sites[2 * active[picked]], y = sites[2 * active[picked] + 1];
+		bool placed = false;
+		for (unsigned int attempt = 0; attempt < attempts && !placed; ++attempt) {
+			// Uniform over the area of the annulus between distance and twice distance.
+			const double angle = 2.0 * pi * ToUniform(random());
+			const double radius = distance * sqrt(1.0 + 3.0 * ToUniform(random()));
+			const double candidateX = x + radius * cos(angle), candidateY = y + radius * sin(angle);
+			if (0.0 <= candidateX && candidateX < width && 0.0 <= candidateY && candidateY < height && isFree(candidateX, candidateY)) {
+				insert(candidateX, candidateY);
+				placed = true;
+			}
+		}
+		if (!placed) {
+			active[picked] = active.back();
+			active.pop_back();
+		}
+	}
+	return (uint32_t)(sites.size() / 2);
+}
+
+WeightedEliminationSiteSampler::WeightedEliminationSiteSampler(unsigned int oversampling, SobolCache *cache)
+	: oversampling(max(1u, oversampling)), candidateSampler(cache) {
+}
+
+uint32_t WeightedEliminationSiteSampler::Sample(double width, double height, uint32_t count, uint64_t seed, vector<double>& sites) {
+	vector<double> candidates;
+	const uint32_t candidateCount = candidateSampler.Sample(width, height, (uint32_t)min<uint64_t>((uint64_t)count * oversampling, 0xFFFFFFFFull), seed, candidates);
+	if (candidateCount <= count || !(0.0 < width && 0.0 < height)) {
+		sites.swap(candidates);
+		return candidateCount;
+	}
+
+	// The parameters of the paper for two dimensions: rMax is the distance of count sites packed hexagonally,
+	// neighbours within 2 rMax weigh (1 - d / 2 rMax)^8, and distances below rMin count as rMin so that pairs already
+	// close in the candidates do not dominate.
+	const double rMax = sqrt(width * height / (2.0 * sqrt(3.0) * count));
+	const double rMin = rMax * (1.0 - pow((double)count / candidateCount, 1.5)) * 0.65;
+	const double reach = 2.0 * rMax;
+	auto weigh = [&](double squaredDistance) {
+		const double closeness = 1.0 - max(sqrt(squaredDistance), rMin) / reach;
+		const double squared = closeness * closeness, fourth = squared * squared;
+		return fourth * fourth;
+	};
+
+	// Candidates bucketed by cells of side reach, so that the neighbours of one are in the 3 x 3 cells around it.
+	const size_t columns = max<size_t>(1, (size_t)ceil(width / reach)), rows = max<size_t>(1, (size_t)ceil(height / reach));
+	auto cellOf = [&](uint32_t candidate) {
+		return min((size_t)(candidates[2 * candidate + 1] / reach), rows - 1) * columns + min((size_t)(candidates[2 * candidate] / reach), columns - 1);
+	};
+	vector<uint32_t> cellStarts(columns * rows + 1, 0), cellCandidates(candidateCount);
+	for (uint32_t i = 0; i < candidateCount; ++i) {
+		++cellStarts[cellOf(i) + 1];
+	}
+	for (size_t cell = 0; cell < columns * rows; ++cell) {
+		cellStarts[cell + 1] += cellStarts[cell];
+	}
+	vector<uint32_t> cellFill(cellStarts.begin(), cellStarts.end() - 1);
+	for (uint32_t i = 0; i < candidateCount; ++i) {
+		cellCandidates[cellFill[cellOf(i)]++] = i;
+	}
+
+	// Calls visit(neighbour, weight) for every candidate left within reach of candidate.
+	vector<bool> removed(candidateCount, false);
+	auto forEachNeighbour = [&](uint32_t candidate, auto visit) {
+		const size_t cell = cellOf(candidate), row = cell / columns, column = cell % columns;
+		const double x = candidates[2 * candidate], y = candidates[2 * candidate + 1];
+		for (size_t neighbourRow = row < 1 ? 0 : row - 1; neighbourRow <= row + 1 && neighbourRow < rows; ++neighbourRow) {
+			for (size_t neighbourColumn = column < 1 ? 0 : column - 1; neighbourColumn <= column + 1 && neighbourColumn < columns; ++neighbourColumn) {
+				const size_t neighbourCell = neighbourRow * columns + neighbourColumn;
+				for (uint32_t k = cellStarts[neighbourCell]; k < cellStarts[neighbourCell + 1]; ++k) {
+					const uint32_t neighbour = cellCandidates[k];
+					if (neighbour == candidate || removed[neighbour]) {
+						continue;
+					}
+					const double dx = candidates[2 * neighbour] - x, dy = candidates[2 * neighbour + 1] - y;
+					const double squaredDistance = dx * dx + dy * dy;
+					if (squaredDistance < reach * reach) {
+						visit(neighbour, weigh(squaredDistance));
+					}
+				}
+			}
+		}
+	};
+
+	vector<double> weights(candidateCount, 0.0);
+	for (uint32_t i = 0; i < candidateCount; ++i) {
+		forEachNeighbour(i, [&](uint32_t, double weight) {
+			weights[i] += weight;
+		});
+	}
+
+	IndexedHeap heap(weights);
+	for (uint32_t left = candidateCount; left > count; --left) {
+		const uint32_t candidate = heap.Pop();
+		removed[candidate] = true;
+		forEachNeighbour(candidate, [&](uint32_t neighbour, double weight) {
+			weights[neighbour] -= weight;
+			heap.Decreased(neighbour);
+		});
+	}
+
+	sites.clear();
+	sites.reserve((size_t)count * 2);
+	for (uint32_t i = 0; i < candidateCount; ++i) {
+		if (!removed[i]) {
+			sites.push_back(candidates[2 * i]);
+			sites.push_back(candidates[2 * i + 1]);
+		}
+	}
+	return count;
+}
\ No newline at end of file
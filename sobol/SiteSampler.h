@@ -0,0 +1,72 @@
+#pragma once
+
+#ifndef SITE_SAMPLER_H
+#define SITE_SAMPLER_H
+
+#include <cstdint>
+#include <vector>
+#include "SobolCache.h"
+
+using namespace std;
+
+// Draws the sites of a map, points of the rectangle [0, width) x [0, height). The samplers trade stratification,
+// spacing and exact counts differently, and the map generator picks one through this interface.
+class SiteSampler {
+public:
+	virtual ~SiteSampler() {}
+
+	// Replaces the content of sites with the sampled sites as x, y pairs and returns their number. seed picks one of
+	// the layouts of the sampler, the same seed always gives the same sites.
+	virtual uint32_t Sample(double width, double height, uint32_t count, uint64_t seed, vector<double>& sites) = 0;
+};
+
+// The Sobol sequence, Owen scrambled unless seed is 0. Exactly count sites, evenly stratified but with no minimum
+// distance between them.
+class SobolSiteSampler : public SiteSampler {
+public:
+	// With a cache, the points are mapped from it and generated into it first if needed.
+	explicit SobolSiteSampler(SobolCache *cache = nullptr);
+
+	uint32_t Sample(double width, double height, uint32_t count, uint64_t seed, vector<double>& sites) override;
+
+private:
+	SobolCache *cache;
+};
+
+// Poisson-disk sampling of Bridson, "Fast Poisson Disk Sampling in Arbitrary Dimensions" (2007): no two sites are
+// closer than the minimum distance, and there is no room left for another one. Sites grow out from random
+// neighbours of active sites, and a background grid of cells of side distance / sqrt(2), each holding at most one
+// site, limits the test of a candidate to the 5 x 5 cells around it, so the whole map takes O(N).
+class PoissonDiskSiteSampler : public SiteSampler {
+public:
+	// minimumDistance 0 derives it from the count, such that a full map holds about count sites. attempts is the
+	// number of candidates tried around a site before it is retired, 30 in the paper.
+	explicit PoissonDiskSiteSampler(double minimumDistance = 0.0, unsigned int attempts = 30);
+
+	// The number of sites is whatever fills the map at the minimum distance, count only sets that distance when it
+	// was left to 0.
+	uint32_t Sample(double width, double height, uint32_t count, uint64_t seed, vector<double>& sites) override;
+	double GetMinimumDistance(double width, double height, uint32_t count) const;
+
+private:
+	double minimumDistance;
+	unsigned int attempts;
+};
+
+// Weighted sample elimination of Yuksel, "Sample Elimination for Generating Poisson Disk Sample Sets" (2015): draws
+// oversampling times count Sobol candidates, weighs each by how crowded its neighbourhood is, and removes the most
+// crowded one at a time until count remain. Exactly count sites with blue noise spacing, O(M log M) for M candidates
+// with a grid for the neighbours and an indexed heap for the weights.
+class WeightedEliminationSiteSampler : public SiteSampler {
+public:
+	// cache is passed on to the Sobol sampler of the candidates.
+	explicit WeightedEliminationSiteSampler(unsigned int oversampling = 5, SobolCache *cache = nullptr);
+
+	uint32_t Sample(double width, double height, uint32_t count, uint64_t seed, vector<double>& sites) override;
+
+private:
+	unsigned int oversampling;
+	SobolSiteSampler candidateSampler;
+};
+
+#endif //SITE_SAMPLER_H
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <thread>
+#include "SobolBenchmark.h"
+#include "SobolGenerator.h"
+#include "SobolKernels.h"
+#include "SobolParallelGenerator.h"
+#include "SobolReference.h"
+
+using namespace std::chrono;
+
+namespace {
+	// Generates the sequence of result.count points again and again with generate(begin, count), which writes
+	// the next count points and returns how many it wrote. restart rewinds to the first point before every pass.
+	// stride is the number of points generated between two reads of the clock.
+	template <typename Generate, typename Restart>
+	void Measure(SobolBenchmarkResult& result, const SobolBenchmarkOptions& options, size_t pointBytes, uint32_t stride, Generate generate, Restart restart) {
+		const steady_clock::time_point start = steady_clock::now();
+		double seconds = 0.0;
+		result.complete = true;
+		do {
+			restart();
+			for (uint64_t begin = 0; begin < result.count; ) {
+				const uint32_t generated = generate((uint32_t)begin, (uint32_t)min<uint64_t>(stride, result.count - begin));
+				if (0 == generated) {
+					break;
+				}
+				begin += generated;
+				result.points += generated;
+				seconds = duration<double>(steady_clock::now() - start).count();
+				if (seconds >= options.maxSeconds && begin < result.count) {
+					result.complete = false;
+					break;
+				}
+			}
+		} while (result.complete && seconds < options.minSeconds);
+		result.seconds = seconds;
+		result.bytes = result.points * pointBytes;
+	}
+
+	// Seed of the scrambled modes, any nonzero one does.
+	const uint64_t scrambleSeed = 1;
+
+	template <typename Generator, typename Output>
+	void MeasureBlocks(SobolBenchmarkResult& result, const SobolBenchmarkOptions& options, SobolScrambling scrambling = SobolScrambling::None) {
+		Generator generator((uint32_t)result.count, result.dimensions);
+		generator.Scramble(scrambling, scrambleSeed);
+		vector<Output> points((size_t)result.batchSize * result.dimensions);
+		Measure(result, options, sizeof(Output) * result.dimensions, result.batchSize, [&](uint32_t, uint32_t count) {
+			return (uint32_t)generator.GetBlock(points.data(), count);
+		}, [&]() {
+			generator.Seek(0);
+		});
+	}
+
+	bool MeasureCase(SobolBenchmarkResult& result, const SobolBenchmarkOptions& options) {
+		const size_t pointBytes = sizeof(double) * result.dimensions;
+		if ("next" == result.mode) {
+			SobolGenerator generator((uint32_t)result.count, result.dimensions);
+			vector<double> point;
+			point.reserve(result.dimensions);
+			Measure(result, options, pointBytes, 1 << 10, [&](uint32_t, uint32_t count) {
+				uint32_t generated = 0;
+				for (; generated < count && generator.GetNext(point); ++generated) {
+					point.clear();
+				}
+				return generated;
+			}, [&]() {
+				generator.Seek(0);
+			});
+		}
+		else if ("block" == result.mode) {
+			MeasureBlocks<SobolGenerator, double>(result, options);
+		}
+		else if ("float" == result.mode) {
+			MeasureBlocks<SobolGenerator, float>(result, options);
+		}
+		else if ("uint32" == result.mode) {
+			MeasureBlocks<SobolGenerator, uint32_t>(result, options);
+		}
+		else if ("shift" == result.mode) {
+			MeasureBlocks<SobolGenerator, double>(result, options, SobolScrambling::DigitalShift);
+		}
+		else if ("owen" == result.mode) {
+			MeasureBlocks<SobolGenerator, double>(result, options, SobolScrambling::Owen);
+		}
+		else if ("block64" == result.mode) {
+			MeasureBlocks<SobolGenerator64, double>(result, options);
+		}
+		else if ("parallel" == result.mode) {
+			ParallelSobolGenerator generator((uint32_t)result.count, result.dimensions, result.threads);
+			vector<double> points((size_t)result.batchSize * result.dimensions);
+			Measure(result, options, pointBytes, result.batchSize, [&](uint32_t begin, uint32_t count) {
+				return generator.Generate(points.data(), begin, count);
+			}, []() {
+			});
+		}
+		else if ("dimension" == result.mode) {
+			ParallelSobolGenerator generator((uint32_t)result.count, result.dimensions, result.threads);
+			vector<double> points((size_t)result.batchSize * result.dimensions);
+			Measure(result, options, pointBytes, result.batchSize, [&](uint32_t begin, uint32_t count) {
+				return generator.GenerateByDimension(points.data(), begin, count);
+			}, []() {
+			});
+		}
+		else if ("reference" == result.mode) {
+			// Reading the direction numbers is left out of the timing.
+			SobolReference reference;
+			if (!reference.Open(options.referenceFile.c_str(), result.dimensions)) {
+				return false;
+			}
+			vector<double> points((size_t)result.batchSize * result.dimensions);
+			Measure(result, options, pointBytes, result.batchSize, [&](uint32_t, uint32_t count) {
+				return (uint32_t)reference.Generate(points.data(), count);
+			}, [&]() {
+				reference.Restart();
+			});
+		}
+		else {
+			return false;
+		}
+		return true;
+	}
+
+	size_t GetOutputBytes(const string& mode) {
+		if ("float" == mode) {
+			return sizeof(float);
+		}
+		if ("uint32" == mode) {
+			return sizeof(uint32_t);
+		}
+		return sizeof(double);
+	}
+
+	bool IsThreaded(const string& mode) {
+		return "parallel" == mode || "dimension" == mode;
+	}
+}
+
+SobolBenchmarkOptions::SobolBenchmarkOptions()
+	: modes({ "next", "block", "float", "uint32", "shift", "owen", "block64", "parallel", "dimension", "reference" }), log2Counts({ 10, 14, 18, 22, 26, 30 }),
+	dimensions({ 2, 3, 16, 256, 4096, 21201 }), batchSizes({ 256, 4096, 65536 }),
+	minSeconds(0.1), maxSeconds(1.0), maxBatchBytes((size_t)256 << 20), threads(0), referenceFile("new-joe-kuo-6.21201") {
+}
+
+vector<SobolBenchmarkResult> RunSobolBenchmark(const SobolBenchmarkOptions& options, ostream *progress) {
+	unsigned int threads = 0 == options.threads ? thread::hardware_concurrency() : options.threads;
+	threads = 0 == threads ? 1 : threads;
+
+	vector<SobolBenchmarkResult> results;
+	for (auto mode = options.modes.begin(); mode != options.modes.end(); ++mode) {
+		for (auto log2Count = options.log2Counts.begin(); log2Count != options.log2Counts.end(); ++log2Count) {
+			for (auto dimensions = options.dimensions.begin(); dimensions != options.dimensions.end(); ++dimensions) {
+				if (*log2Count > 31 || 0 == *dimensions || *dimensions > globalNewJoeKuo621201.dimensions) {
+					continue;
+				}
+				// next generates a point at a time, its batch sizes all come down to a single case.
+				const bool batched = "next" != *mode;
+				const uint64_t count = (uint64_t)1 << *log2Count;
+				// Batches beyond the count or the byte limit are cut down, which can make several of them the same.
+				const size_t batchLimit = min<size_t>((size_t)count, max<size_t>(1, options.maxBatchBytes / (GetOutputBytes(*mode) * *dimensions)));
+				vector<uint32_t> measuredBatchSizes;
+				for (auto batchSize = options.batchSizes.begin(); batchSize != options.batchSizes.end(); ++batchSize) {
+					const uint32_t usedBatchSize = batched ? (uint32_t)min<size_t>(*batchSize, batchLimit) : 1;
+					if (0 == usedBatchSize || measuredBatchSizes.end() != find(measuredBatchSizes.begin(), measuredBatchSizes.end(), usedBatchSize)) {
+						continue;
+					}
+					measuredBatchSizes.push_back(usedBatchSize);
+
+					SobolBenchmarkResult result;
+					result.mode = *mode;
+					result.count = count;
+					result.dimensions = *dimensions;
+					result.batchSize = usedBatchSize;
+					result.threads = IsThreaded(*mode) ? threads : 1;
+					result.points = 0;
+					result.bytes = 0;
+					result.seconds = 0.0;
+					if (!MeasureCase(result, options)) {
+						if (nullptr != progress) {
+							*progress << result.mode << " 2^" << *log2Count << " x " << result.dimensions << ": skipped" << endl;
+						}
+						break;
+					}
+					results.push_back(result);
+					if (nullptr != progress) {
+						*progress << result.mode << " 2^" << *log2Count << " x " << result.dimensions << " batch " << result.batchSize << ": ";
+						if (0.0 < result.seconds) {
+							*progress << (uint64_t)(result.points / result.seconds) << " points/s";
+						}
+						else {
+							*progress << "too fast to time";
+						}
+						*progress << (result.complete ? "" : " (partial)") << endl;
+					}
+				}
+			}
+		}
+	}
+	return results;
+}
+
+void WriteSobolBenchmarkJson(ostream& json, const SobolBenchmarkOptions& options, const vector<SobolBenchmarkResult>& results) {
+	json << setprecision(9);
+	json << "{\n\t\"kernels\": \"" << SobolKernels::Name() << "\",\n";
+	json << "\t\"hardwareThreads\": " << thread::hardware_concurrency() << ",\n";
+	json << "\t\"minSeconds\": " << options.minSeconds << ",\n\t\"maxSeconds\": " << options.maxSeconds << ",\n";
+	json << "\t\"results\": [";
+	for (auto result = results.begin(); result != results.end(); ++result) {
+		json << (results.begin() == result ? "" : ",") << "\n\t\t{ \"mode\": \"" << result->mode << "\", \"count\": " << result->count
+			<< ", \"dimensions\": " << result->dimensions << ", \"batchSize\": " << result->batchSize << ", \"threads\": " << result->threads
+			<< ", \"points\": " << result->points << ", \"bytes\": " << result->bytes << ", \"seconds\": " << result->seconds
+			<< ", \"complete\": " << (result->complete ? "true" : "false");
+		if (0.0 < result->seconds) {
+			json << ", \"pointsPerSecond\": " << result->points / result->seconds << ", \"bytesPerSecond\": " << result->bytes / result->seconds << " }";
+		}
+		else {
+			json << ", \"pointsPerSecond\": null, \"bytesPerSecond\": null }";
+		}
+	}
+	json << "\n\t]\n}" << endl;
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#ifndef SOBOL_BENCHMARK_H
+#define SOBOL_BENCHMARK_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// What RunSobolBenchmark measures. Every mode listed in modes runs for every count, dimension count and batch size
+// (next ignores the batch size), generating the sequence of count points from the start in batches.
+//   next       SobolGenerator::GetNext, one point at a time
+//   block      SobolGenerator::GetBlock into doubles
+//   float      SobolGenerator::GetBlock into floats
+//   uint32     SobolGenerator::GetBlock into raw words
+//   shift      block with SobolScrambling::DigitalShift
+//   owen       block with SobolScrambling::Owen
+//   block64    SobolGenerator64::GetBlock into doubles
+//   parallel   ParallelSobolGenerator::Generate, one batch at a time on every thread
+//   dimension  ParallelSobolGenerator::GenerateByDimension, the threads splitting the dimensions of every batch
+//   reference  SobolReference::Generate, skipped if referenceFile cannot be read
+struct SobolBenchmarkOptions {
+	SobolBenchmarkOptions();
+
+	vector<string> modes;
+	// The counts are 2^log2Counts[i], at most 2^31.
+	vector<unsigned int> log2Counts;
+	vector<unsigned short> dimensions;
+	vector<uint32_t> batchSizes;
+	// A case repeats the sequence until it ran for minSeconds, and stops partway once it ran for maxSeconds, so that
+	// the small counts are timed accurately and the large ones stay affordable.
+	double minSeconds, maxSeconds;
+	// Batches are shrunk to fit this many bytes of output, whatever the dimension count.
+	size_t maxBatchBytes;
+	// 0 uses one thread per hardware thread.
+	unsigned int threads;
+	string referenceFile;
+};
+
+struct SobolBenchmarkResult {
+	string mode;
+	uint64_t count;
+	unsigned short dimensions;
+	// Batch size actually used, after the limit of maxBatchBytes.
+	uint32_t batchSize;
+	unsigned int threads;
+	// Points and bytes of output generated over all the passes, and the time they took. seconds can be 0 when a
+	// case is too short for the clock, which leaves it without a rate.
+	uint64_t points, bytes;
+	double seconds;
+	// false if the case stopped before the end of the sequence.
+	bool complete;
+};
+
+// Runs every case of options, writing one line per case to progress unless it is null.
+vector<SobolBenchmarkResult> RunSobolBenchmark(const SobolBenchmarkOptions& options, ostream *progress = nullptr);
+// Writes the options and results as a JSON document, with the points and bytes per second of every case, null
+// for a case without a rate, and the kernels (scalar, sse2 or avx2) the generators ran on.
+void WriteSobolBenchmarkJson(ostream& json, const SobolBenchmarkOptions& options, const vector<SobolBenchmarkResult>& results);
+
+#endif //SOBOL_BENCHMARK_H
\ No newline at end of file
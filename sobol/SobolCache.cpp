@@ -0,0 +1,190 @@
+#include "pch.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include "SobolCache.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace {
+	// Start of every cache file, 64 bytes so that the points after it stay aligned. Little endian, as the points.
+	struct CacheHeader {
+		char magic[8];
+		uint32_t version;
+		uint32_t output;
+		// Hash of the direction numbers of the dimensions in use
+		uint64_t directions;
+		uint64_t seed;
+		uint32_t count;
+		uint32_t dimensions;
+		uint32_t scrambling;
+		uint32_t reserved;
+		uint64_t pointsBytes;
+		uint64_t padding;
+	};
+	static_assert(64 == sizeof(CacheHeader), "the points are expected 64 bytes into a cache file");
+
+	const char cacheMagic[8] = { 'S', 'O', 'B', 'O', 'L', 'P', 'T', 'S' };
+	// Bump when the layout of the files or the points generated for a key change.
+	const uint32_t cacheVersion = 1;
+
+	uint64_t Hash(uint64_t hash, const void *data, size_t size) {
+		for (size_t i = 0; i < size; ++i) {
+			hash = (hash ^ ((const unsigned char *)data)[i]) * 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	size_t GetOutputBytes(SobolCacheOutput output) {
+		return SobolCacheOutput::Double == output ? sizeof(double) : SobolCacheOutput::Float == output ? sizeof(float) : sizeof(uint32_t);
+	}
+
+	CacheHeader MakeHeader(const SobolCacheKey& key) {
+		CacheHeader header;
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+		header.version = cacheVersion;
+		header.output = (uint32_t)key.output;
+
+		// The first dimension has no direction data.
+		const DirectionSet& directionSet = *key.directionSet;
+		uint64_t directions = 0xcbf29ce484222325ull;
+		for (unsigned int j = 1; j < key.dimensions && j < directionSet.dimensions; ++j) {
+			const PackedDirection& direction = directionSet.directions[j - 1];
+			const unsigned int degreeAndCoefficients = direction.degreeAndCoefficients;
+			directions = Hash(directions, &degreeAndCoefficients, sizeof(degreeAndCoefficients));
+			directions = Hash(directions, directionSet.initialDirections + direction.offset, sizeof(unsigned int) * direction.Degree());
+		}
+		header.directions = directions;
+		header.seed = SobolScrambling::None == key.scrambling ? 0 : key.seed;
+		header.count = key.count;
+		header.dimensions = key.dimensions;
+		header.scrambling = (uint32_t)key.scrambling;
+		header.pointsBytes = (uint64_t)key.count * key.dimensions * GetOutputBytes(key.output);
+		return header;
+	}
+
+	bool IsValid(const MappedFile& file, const CacheHeader& header) {
+		return file.IsOpen() && file.GetSize() == sizeof(header) + header.pointsBytes && 0 == memcmp(file.GetData(), &header, sizeof(header));
+	}
+
+	// Creates directory and its missing parents. Failures show up when creating the file in it.
+	void MakeDirectory(const string& directory) {
+		for (size_t end = 1; end <= directory.size(); ++end) {
+			if (directory.size() == end || '/' == directory[end] || '\\' == directory[end]) {
+				const string parent = directory.substr(0, end);
+#ifdef _WIN32
+				_mkdir(parent.c_str());
+#else
+				mkdir(parent.c_str(), 0755);
+#endif
+			}
+		}
+	}
+
+	// A name no other thread or process picks for its temporary file.
+	string MakeTemporarySuffix() {
+		static atomic<uint64_t> counter(0);
+		static const uint64_t processKey = ((uint64_t)random_device()() << 32) ^ random_device()()
+			^ (uint64_t)chrono::steady_clock::now().time_since_epoch().count();
+		const uint64_t key = processKey ^ ((counter.fetch_add(1) + 1) * 0x9e3779b97f4a7c15ull);
+		char suffix[32];
+		snprintf(suffix, sizeof(suffix), ".%016llx.tmp", (unsigned long long)key);
+		return suffix;
+	}
+
+	template <typename Output>
+	void GeneratePoints(const SobolCacheKey& key, void *points) {
+		SobolGenerator generator(key.count, key.dimensions, *key.directionSet);
+		if (SobolScrambling::None != key.scrambling) {
+			generator.Scramble(key.scrambling, key.seed);
+		}
+		generator.GetBlock((Output *)points, key.count);
+	}
+}
+
+SobolCacheKey::SobolCacheKey(uint32_t count, unsigned short dimensions, SobolCacheOutput output, SobolScrambling scrambling, uint64_t seed, const DirectionSet& directionSet)
+	: count(count), dimensions(dimensions), output(output), scrambling(scrambling), seed(seed), directionSet(&directionSet) {
+}
+
+SobolCacheEntry::SobolCacheEntry()
+	: count(0), dimensions(0), output(SobolCacheOutput::Double), generated(false) {
+}
+
+const void *SobolCacheEntry::GetPoints(SobolCacheOutput type) const {
+	if (!file.IsOpen() || output != type) {
+		return nullptr;
+	}
+	return (const char *)file.GetData() + sizeof(CacheHeader);
+}
+
+SobolCache::SobolCache(const string& directory)
+	: directory(directory) {
+}
+
+string SobolCache::GetPath(const SobolCacheKey& key) const {
+	const CacheHeader header = MakeHeader(key);
+	char name[32];
+	snprintf(name, sizeof(name), "sobol-%016llx.points", (unsigned long long)Hash(0xcbf29ce484222325ull, &header, sizeof(header)));
+	return directory.empty() ? string(name) : directory + "/" + name;
+}
+
+bool SobolCache::Get(const SobolCacheKey& key, SobolCacheEntry& entry) {
+	entry.Close();
+	if (0 == key.count || 0 == key.dimensions || key.dimensions > key.directionSet->dimensions) {
+		return false;
+	}
+	const CacheHeader header = MakeHeader(key);
+	const string path = GetPath(key);
+	entry.count = key.count;
+	entry.dimensions = key.dimensions;
+	entry.output = key.output;
+	entry.generated = false;
+	if (entry.file.Open(path.c_str()) && IsValid(entry.file, header)) {
+		return true;
+	}
+	entry.file.Close();
+
+	const uint64_t fileBytes = sizeof(header) + header.pointsBytes;
+	if ((size_t)fileBytes != fileBytes) {
+		return false;
+	}
+	MakeDirectory(directory);
+	const string temporaryPath = path + MakeTemporarySuffix();
+	MappedFile file;
+	if (!file.Create(temporaryPath.c_str(), (size_t)fileBytes)) {
+		remove(temporaryPath.c_str());
+		return false;
+	}
+	char *data = (char *)file.GetWritableData();
+	memcpy(data, &header, sizeof(header));
+	if (SobolCacheOutput::Double == key.output) {
+		GeneratePoints<double>(key, data + sizeof(header));
+	}
+	else if (SobolCacheOutput::Float == key.output) {
+		GeneratePoints<float>(key, data + sizeof(header));
+	}
+	else {
+		GeneratePoints<uint32_t>(key, data + sizeof(header));
+	}
+	const bool flushed = file.Flush();
+	file.Close();
+	// When the rename fails another process may have renamed the same points into place, or holds the previous
+	// file mapped on Windows: whatever is at path is checked again below.
+	if (!flushed || !MappedFile::Replace(temporaryPath.c_str(), path.c_str())) {
+		remove(temporaryPath.c_str());
+	}
+	entry.generated = true;
+	if (entry.file.Open(path.c_str()) && IsValid(entry.file, header)) {
+		return true;
+	}
+	entry.file.Close();
+	return false;
+}
\ No newline at end of file
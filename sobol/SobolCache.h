@@ -0,0 +1,89 @@
+#pragma once
+
+#ifndef SOBOL_CACHE_H
+#define SOBOL_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include "SobolGenerator.h"
+#include "MappedFile.h"
+
+using namespace std;
+
+// Output types of the cached points, as the GetBlock overloads of SobolGenerator write them.
+enum class SobolCacheOutput {
+	Double,
+	Float,
+	// The raw 32 bit words
+	Word
+};
+
+// Everything the points of a cache entry depend on.
+struct SobolCacheKey {
+	SobolCacheKey(uint32_t count, unsigned short dimensions, SobolCacheOutput output = SobolCacheOutput::Double,
+		SobolScrambling scrambling = SobolScrambling::None, uint64_t seed = 0, const DirectionSet& directionSet = globalNewJoeKuo621201);
+
+	uint32_t count;
+	unsigned short dimensions;
+	SobolCacheOutput output;
+	SobolScrambling scrambling;
+	uint64_t seed;
+	// Only the direction numbers of the first dimensions dimensions matter, the cache keys them by content.
+	const DirectionSet *directionSet;
+};
+
+// The points of one cache entry, mapped read-only.
+class SobolCacheEntry {
+public:
+	SobolCacheEntry();
+
+	bool IsOpen() const { return file.IsOpen(); }
+	uint32_t GetCount() const { return count; }
+	unsigned short GetDimensions() const { return dimensions; }
+	SobolCacheOutput GetOutput() const { return output; }
+	// false when the points were mapped from an existing file, true when they had to be generated first.
+	bool WasGenerated() const { return generated; }
+	// GetCount() points laid out point-major, nullptr unless the entry holds that output type.
+	const double *GetDoubles() const { return (const double *)GetPoints(SobolCacheOutput::Double); }
+	const float *GetFloats() const { return (const float *)GetPoints(SobolCacheOutput::Float); }
+	const uint32_t *GetWords() const { return (const uint32_t *)GetPoints(SobolCacheOutput::Word); }
+	void Close() { file.Close(); }
+
+private:
+	friend class SobolCache;
+
+	const void *GetPoints(SobolCacheOutput type) const;
+
+	MappedFile file;
+	uint32_t count;
+	unsigned short dimensions;
+	SobolCacheOutput output;
+	bool generated;
+};
+
+// A directory of generated point sets, content addressed: the name of the file of a key is a hash of the key,
+// direction numbers included, so a lookup is a single open and map whatever the number of entries. Every file starts
+// with a header repeating the key, checked on lookup, so a hash collision or a stale format is regenerated instead of
+// returned.
+// A missing entry is generated into a temporary file of its own, flushed and then atomically renamed into place, so
+// processes filling the same cache concurrently never see a partial file: at worst several of them generate the same
+// points and the last rename wins with identical content.
+//   SobolCache cache("Saved/SobolCache");
+//   SobolCacheEntry sites;
+//   if (cache.Get(SobolCacheKey(count, 2, SobolCacheOutput::Double, SobolScrambling::Owen, seed), sites)) { ... }
+class SobolCache {
+public:
+	// directory is created on the first entry generated if it does not exist.
+	explicit SobolCache(const string& directory);
+
+	// Maps the points of key into entry, generating them into the cache first if needed. Returns false if they are
+	// neither in the cache nor can be written to it, the caller should generate them directly then.
+	bool Get(const SobolCacheKey& key, SobolCacheEntry& entry);
+	// Path of the file of key, whether it exists or not.
+	string GetPath(const SobolCacheKey& key) const;
+
+private:
+	string directory;
+};
+
+#endif //SOBOL_CACHE_H
\ No newline at end of file
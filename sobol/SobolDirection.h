@@ -3,21 +3,33 @@
 #ifndef SOBOL_DIRECTION_H
 #define SOBOL_DIRECTION_H
 
-struct Direction {
-	unsigned short dimension;
-	unsigned int degree;
-	unsigned int coefficients;
-	unsigned int *initialDirections;
-	static void Init(Direction& instance, unsigned short dimension, unsigned int coefficients, unsigned int degree, ...);
+// Direction data of one dimension packed in 8 bytes: the degree of its primitive polynomial in the low 5 bits and
+// the polynomial coefficients above them, then where its initial direction numbers m_1 to m_degree start in the
+// pool of the direction set.
+struct PackedDirection {
+	unsigned int degreeAndCoefficients;
+	unsigned int offset;
+
+	unsigned int Degree() const { return degreeAndCoefficients & 0x1F; }
+	unsigned int Coefficients() const { return degreeAndCoefficients >> 5; }
 };
 
-class NewJoeKuo621201 {
-public:
-	NewJoeKuo621201();
-	Direction directions[21201];
-	unsigned short dimensions;
+constexpr PackedDirection PackDirection(unsigned int degree, unsigned int coefficients, unsigned int offset) {
+	return PackedDirection{ degree | (coefficients << 5), offset };
+}
+
+// A set of direction numbers: one packed direction per dimension from the second one on (the first dimension has
+// no direction data, all its m's are 1) and one contiguous pool holding every initial direction number.
+struct DirectionSet {
+	// directions[i] is the direction of dimension i + 2
+	const PackedDirection *directions;
+	const unsigned int *initialDirections;
+	// Number of dimensions the set supports, including the first one.
+	unsigned int dimensions;
 };
 
-const NewJoeKuo621201 globalNewJoeKuo621201 = NewJoeKuo621201();
+// Direction numbers new-joe-kuo-6.21201 by S. Joe and F. Y. Kuo, 21201 dimensions, compiled in as read-only data.
+// Records and initial direction numbers are in dimension order, so only the pages of the dimensions in use get loaded.
+extern const DirectionSet globalNewJoeKuo621201;
 
-#endif SOBOL_DIRECTION_H
\ No newline at end of file
+#endif //SOBOL_DIRECTION_H
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "pch.h"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "SobolDirectionFile.h"
+
+using namespace std;
+
+static const char directionFileMagic[8] = { 'S', 'O', 'B', 'O', 'L', 'D', 'I', 'R' };
+
+bool WriteDirectionFile(const DirectionSet& directionSet, unsigned int dimensions, const char *binaryPath) {
+	if (0 == dimensions || dimensions > directionSet.dimensions) {
+		return false;
+	}
+
+	DirectionFileHeader header;
+	memcpy(header.magic, directionFileMagic, sizeof(header.magic));
+	header.version = DirectionFileVersion;
+	header.dimensions = dimensions;
+	header.initialDirectionCount = 0;
+	header.reserved = 0;
+
+	// Pack the pool of the written dimensions only, the source set may hold more or be in any order.
+	vector<PackedDirection> directions;
+	vector<unsigned int> initialDirections;
+	for (unsigned int i = 0; i + 1 < dimensions; ++i) {
+		PackedDirection direction = directionSet.directions[i];
+		const unsigned int *m = directionSet.initialDirections + direction.offset;
+		direction.offset = (unsigned int)initialDirections.size();
+		initialDirections.insert(initialDirections.end(), m, m + direction.Degree());
+		directions.push_back(direction);
+	}
+	header.initialDirectionCount = (unsigned int)initialDirections.size();
+
+	ofstream outfile(binaryPath, ios::out | ios::binary | ios::trunc);
+	if (!outfile) {
+		return false;
+	}
+	outfile.write((const char *)&header, sizeof(header));
+	outfile.write((const char *)directions.data(), sizeof(PackedDirection) * directions.size());
+	outfile.write((const char *)initialDirections.data(), sizeof(unsigned int) * initialDirections.size());
+	outfile.close();
+	return !outfile.fail();
+}
+
+bool ConvertJoeKuoDirections(const char *textPath, const char *binaryPath) {
+	ifstream infile(textPath, ios::in);
+	if (!infile) {
+		return false;
+	}
+	char buffer[1000];
+	infile.getline(buffer, 1000, '\n');
+
+	vector<PackedDirection> directions;
+	vector<unsigned int> initialDirections;
+	unsigned int d, s, a;
+	while (infile >> d >> s >> a) {
+		// The degree has to fit in the 5 bits PackedDirection keeps for it, and the coefficients in the other 27.
+		if (d != directions.size() + 2 || 0 == s || s > 31 || a >= (1u << 27)) {
+			return false;
+		}
+		directions.push_back(PackDirection(s, a, (unsigned int)initialDirections.size()));
+		for (unsigned int i = 0; i < s; ++i) {
+			unsigned int m;
+			if (!(infile >> m)) {
+				return false;
+			}
+			initialDirections.push_back(m);
+		}
+	}
+	if (!infile.eof()) {
+		return false;
+	}
+
+	DirectionSet directionSet = { directions.data(), initialDirections.data(), (unsigned int)directions.size() + 1 };
+	return WriteDirectionFile(directionSet, directionSet.dimensions, binaryPath);
+}
+
+MappedDirectionSet::MappedDirectionSet() {
+	directionSet.directions = nullptr;
+	directionSet.initialDirections = nullptr;
+	directionSet.dimensions = 0;
+}
+
+bool MappedDirectionSet::Open(const char *path, unsigned int dimensions) {
+	Close();
+	if (!file.Open(path, 0 != dimensions)) {
+		return false;
+	}
+
+	const size_t size = file.GetSize();
+	const char *data = (const char *)file.GetData();
+	if (size < sizeof(DirectionFileHeader)) {
+		Close();
+		return false;
+	}
+	const DirectionFileHeader *header = (const DirectionFileHeader *)data;
+	if (0 != memcmp(header->magic, directionFileMagic, sizeof(header->magic)) || DirectionFileVersion != header->version || 0 == header->dimensions) {
+		Close();
+		return false;
+	}
+
+	const size_t directionsSize = sizeof(PackedDirection) * (header->dimensions - 1);
+	const size_t initialDirectionsSize = sizeof(unsigned int) * header->initialDirectionCount;
+	if (size != sizeof(DirectionFileHeader) + directionsSize + initialDirectionsSize) {
+		Close();
+		return false;
+	}
+
+	if (0 == dimensions) {
+		dimensions = header->dimensions;
+	}
+	if (dimensions > header->dimensions) {
+		Close();
+		return false;
+	}
+
+	const PackedDirection *directions = (const PackedDirection *)(data + sizeof(DirectionFileHeader));
+	for (unsigned int i = 0; i + 1 < dimensions; ++i) {
+		const unsigned int degree = directions[i].Degree();
+		if (0 == degree || degree > header->initialDirectionCount || directions[i].offset > header->initialDirectionCount - degree) {
+			Close();
+			return false;
+		}
+	}
+
+	directionSet.directions = directions;
+	directionSet.initialDirections = (const unsigned int *)(data + sizeof(DirectionFileHeader) + directionsSize);
+	directionSet.dimensions = dimensions;
+	return true;
+}
+
+void MappedDirectionSet::Close() {
+	file.Close();
+	directionSet.directions = nullptr;
+	directionSet.initialDirections = nullptr;
+	directionSet.dimensions = 0;
+}
\ No newline at end of file
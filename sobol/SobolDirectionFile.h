@@ -0,0 +1,54 @@
+#pragma once
+
+#ifndef SOBOL_DIRECTION_FILE_H
+#define SOBOL_DIRECTION_FILE_H
+
+#include "MappedFile.h"
+#include "SobolDirection.h"
+
+// Binary direction set file. Little endian, laid out exactly as a DirectionSet so it can be used in place:
+//   DirectionFileHeader
+//   PackedDirection directions[dimensions - 1]
+//   unsigned int initialDirections[initialDirectionCount]
+struct DirectionFileHeader {
+	char magic[8]; // "SOBOLDIR"
+	unsigned int version;
+	unsigned int dimensions;
+	unsigned int initialDirectionCount;
+	unsigned int reserved;
+};
+
+const unsigned int DirectionFileVersion = 1;
+
+// Writes the first dimensions dimensions of directionSet as a binary direction set file.
+bool WriteDirectionFile(const DirectionSet& directionSet, unsigned int dimensions, const char *binaryPath);
+
+// Converts a direction number file in the text format of Joe and Kuo ("new-joe-kuo-6.21201": a header line, then
+// "d s a m_1 ... m_s" for every dimension d from 2 on) into a binary direction set file.
+// Returns false if the text cannot be parsed or the binary file cannot be written.
+bool ConvertJoeKuoDirections(const char *textPath, const char *binaryPath);
+
+// A binary direction set file mapped into memory, the direction set points straight into the mapping so nothing is
+// parsed or copied. The direction set is valid until the file is closed.
+// Only the dimensions asked for are ever read: a generator touches the records and initial direction numbers of its
+// own dimensions, which are at the front of their sections, so a 2 dimensional consumer pages in a few kilobytes of
+// even the 21201 dimension set.
+class MappedDirectionSet {
+public:
+	MappedDirectionSet();
+
+	// Maps the file at path and validates its first dimensions dimensions, which are all the direction set exposes
+	// (0 for every dimension of the file). Returns false if it is missing, is not a valid direction set file, or has
+	// fewer dimensions.
+	bool Open(const char *path, unsigned int dimensions = 0);
+	void Close();
+
+	bool IsOpen() const { return file.IsOpen(); }
+	const DirectionSet& GetDirectionSet() const { return directionSet; }
+
+private:
+	MappedFile file;
+	DirectionSet directionSet;
+};
+
+#endif //SOBOL_DIRECTION_FILE_H
\ No newline at end of file
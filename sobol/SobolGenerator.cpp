@@ -2,85 +2,462 @@
 
 #include <iostream>
 #include "SobolGenerator.h"
+#include "SobolKernels.h"
 
-const double dividend = pow(2.0, 32);
+template <typename Word>
+void ComputeDirectionNumbers(const DirectionSet& directionSet, unsigned short nthDimension, unsigned int bits, Word *column, size_t stride) {
+	const unsigned int Bits = SobolWord<Word>::Bits;
+	if (1 == nthDimension) {
+		for (unsigned int i = 1; i <= bits; ++i) {
+			column[i * stride] = (Word)1 << (Bits - i); // all m's = 1 for the first dimension
+		}
+		return;
+	}
 
-SobolGenerator::SobolGenerator(unsigned int maxGenerating, unsigned short dimensions) {
-	this->maxGenerating = maxGenerating;
+	const PackedDirection direction = directionSet.directions[nthDimension - 2]; // direction data store dimension data start by 2 --Zachary
+	const unsigned int degree = direction.Degree(), coefficients = direction.Coefficients();
+	const unsigned int *initialDirections = directionSet.initialDirections + direction.offset;
+	if (bits <= degree) {
+		for (unsigned int i = 1; i <= bits; ++i) {
+			column[i * stride] = (Word)initialDirections[i - 1] << (Bits - i);
+		}
+	}
+	else {
+		for (unsigned int i = 1; i <= degree; ++i) {
+			column[i * stride] = (Word)initialDirections[i - 1] << (Bits - i);
+		}
+		for (unsigned int i = degree + 1; i <= bits; ++i) {
+			Word value = column[(i - degree) * stride];
+			value ^= value >> degree;
+			for (unsigned int k = 1; k <= degree - 1; ++k) {
+				value ^= (((coefficients >> (degree - 1 - k)) & 1) * column[(i - k) * stride]);
+			}
+			column[i * stride] = value;
+		}
+	}
+}
+
+template <typename Word>
+BasicSobolGenerator<Word>::BasicSobolGenerator(Word maxGenerating, unsigned short dimensions, const DirectionSet& directionSet)
+	: BasicSobolGenerator(maxGenerating, dimensions, directionSet, false) {
+}
+
+template <typename Word>
+BasicSobolGenerator<Word>::BasicSobolGenerator(SobolUnbounded, unsigned short dimensions, const DirectionSet& directionSet)
+	: BasicSobolGenerator(~(Word)0, dimensions, directionSet, true) {
+}
+
+template <typename Word>
+BasicSobolGenerator<Word>::BasicSobolGenerator(Word maxGenerating, unsigned short dimensions, const DirectionSet& directionSet, bool isUnbounded) {
 	this->dimensions = dimensions;
-	requiredBits = (unsigned int)ceil(log((double)this->maxGenerating) / log(2.0));
+	requiredBits = 0;
+	if (isUnbounded) {
+		this->maxGenerating = maxGenerating;
+		this->directionSet = &directionSet;
+	}
+	else {
+		this->maxGenerating = maxGenerating;
+		this->directionSet = nullptr;
+		// ceil(log2(maxGenerating)), computed on the integer so that it stays exact for 64 bit lengths
+		for (Word last = 1 < maxGenerating ? maxGenerating - 1 : 0; 0 != last; last >>= 1) {
+			++requiredBits;
+		}
+	}
 
 	previousC = 1;
-	previousXByDimension = new unsigned int[dimensions];
-	memset(previousXByDimension, 0, sizeof(unsigned int) * dimensions);
+	previousXByDimension = new Word[dimensions];
+	memset(previousXByDimension, 0, sizeof(Word) * dimensions);
+	scrambling = SobolScrambling::None;
+	scrambleKeys = new Word[dimensions];
+	memset(scrambleKeys, 0, sizeof(Word) * dimensions);
+	scrambledX = nullptr;
 
-	V = new unsigned int[requiredBits + 1];
-	memset(V, 0, sizeof(unsigned int) * (requiredBits + 1));
+	V = new Word[(size_t)(requiredBits + 1) * dimensions];
+	memset(V, 0, sizeof(Word) * (requiredBits + 1) * dimensions);
+	InitDirectionNumbers(directionSet);
 
 	currentGenerating = 0;
 }
 
-bool SobolGenerator::GetNext(vector<double>& point) {
-	if (currentGenerating == maxGenerating) {
+template <typename Word>
+BasicSobolGenerator<Word>::BasicSobolGenerator(const BasicSobolGenerator& other) {
+	maxGenerating = other.maxGenerating;
+	currentGenerating = other.currentGenerating;
+	dimensions = other.dimensions;
+	requiredBits = other.requiredBits;
+	directionSet = other.directionSet;
+	previousC = other.previousC;
+
+	previousXByDimension = new Word[dimensions];
+	memcpy(previousXByDimension, other.previousXByDimension, sizeof(Word) * dimensions);
+	scrambling = other.scrambling;
+	scrambleKeys = new Word[dimensions];
+	memcpy(scrambleKeys, other.scrambleKeys, sizeof(Word) * dimensions);
+	scrambledX = nullptr == other.scrambledX ? nullptr : new Word[dimensions];
+
+	V = new Word[(size_t)(requiredBits + 1) * dimensions];
+	memcpy(V, other.V, sizeof(Word) * (requiredBits + 1) * dimensions);
+}
+
+template <typename Word>
+void BasicSobolGenerator<Word>::InitDirectionNumbers(const DirectionSet& directionSet) {
+	for (unsigned short nthDimension = 1; nthDimension <= dimensions; ++nthDimension) {
+		ComputeDirectionNumbers(directionSet, nthDimension, requiredBits, V + (nthDimension - 1), dimensions);
+	}
+}
+
+template <typename Word>
+void BasicSobolGenerator<Word>::Grow(unsigned int bits) {
+	Word *grown = new Word[(size_t)(bits + 1) * dimensions];
+	memset(grown, 0, sizeof(Word) * dimensions);
+	delete[] V;
+	V = grown;
+	requiredBits = bits;
+	InitDirectionNumbers(*directionSet);
+}
+
+template <typename Word>
+Word BasicSobolGenerator<Word>::GetCovered() const {
+	if (nullptr == directionSet || Bits == requiredBits) {
+		return maxGenerating;
+	}
+	return (Word)1 << requiredBits;
+}
+
+template <typename Word>
+bool BasicSobolGenerator<Word>::Reserve(Word count) {
+	if (count > maxGenerating) {
 		return false;
 	}
 
-	if (0 == currentGenerating) {
-		for (unsigned int i = 0; i < dimensions; ++i) {
-			point.push_back(0.0);
+	if (count > GetCovered()) {
+		unsigned int bits = 0;
+		for (Word last = count - 1; 0 != last; last >>= 1) {
+			++bits;
 		}
+		Grow(bits);
+	}
+	return true;
+}
+
+template <typename Word>
+void BasicSobolGenerator<Word>::Scramble(SobolScrambling scrambling, uint64_t seed) {
+	this->scrambling = scrambling;
+	for (unsigned short j = 0; j < dimensions; ++j) {
+		scrambleKeys[j] = SobolScrambling::None == scrambling ? 0 : SobolScrambleKey<Word>(seed, j);
+	}
+	if (SobolScrambling::None != scrambling && nullptr == scrambledX) {
+		scrambledX = new Word[dimensions];
+	}
+}
+
+template <typename Word>
+const Word *BasicSobolGenerator<Word>::GetScrambledX() {
+	if (SobolScrambling::None == scrambling) {
+		return previousXByDimension;
+	}
+	for (unsigned short j = 0; j < dimensions; ++j) {
+		scrambledX[j] = SobolScramble(scrambling, previousXByDimension[j], scrambleKeys[j]);
+	}
+	return scrambledX;
+}
+
+template <typename Word>
+void BasicSobolGenerator<Word>::ToUnit(const Word *X, double *point) const {
+	if (SobolScrambling::DigitalShift == scrambling) {
+		SobolKernels::ShiftToUnit(X, scrambleKeys, point, dimensions);
+	}
+	else if (SobolScrambling::Owen == scrambling) {
+		SobolKernels::OwenToUnit(X, scrambleKeys, point, dimensions);
+	}
+	else {
+		SobolKernels::ToUnit(X, point, dimensions);
+	}
+}
+
+// Moves to the next point, returns the direction numbers to XOR into previousXByDimension to reach it,
+// or nullptr for the first point which is all zeros.
+template <typename Word>
+const Word *BasicSobolGenerator<Word>::Advance() {
+	if (0 == currentGenerating) {
 		++currentGenerating;
-		return true;
+		return nullptr;
 	}
 
-	unsigned int C = 0, X = 0;
+	if (previousC > requiredBits) {
+		Grow(previousC); // only an unbounded generator gets there
+	}
+	const Word *directionRow = V + previousC * dimensions;
+	previousC = SobolRightmostZeroBit(currentGenerating);
+	++currentGenerating;
+	return directionRow;
+}
 
-	for (unsigned int i = 1; i <= requiredBits; ++i) {
-		V[i] = 1 << (32 - i);
+template <typename Word>
+bool BasicSobolGenerator<Word>::GetNext(vector<double>& point) {
+	if (currentGenerating == maxGenerating) {
+		return false;
+	}
+
+	const Word *directionRow = Advance();
+	if (nullptr == directionRow) {
+		for (unsigned short i = 0; i < dimensions; ++i) {
+			point.push_back(ToUnit(0, i));
+		}
+		return true;
 	}
 
-	C = 1;
-	auto temp = currentGenerating;
-	while (temp & 1) {
-		temp >>= 1;
-		C++;
+	for (unsigned short i = 0; i < dimensions; ++i) {
+		Word X = previousXByDimension[i] ^ directionRow[i];
+		point.push_back(ToUnit(X, i));
+		previousXByDimension[i] = X;
 	}
+	return true;
+}
 
-	X = previousXByDimension[0] ^ V[previousC];
-	point.push_back((double)X / dividend);
-	previousXByDimension[0] = X;
+template <typename Word>
+Word BasicSobolGenerator<Word>::GetBlock(double *points, Word count, SobolLayout layout, size_t dimensionStride) {
+	if (0 == dimensionStride) {
+		dimensionStride = (size_t)count;
+	}
+	if (maxGenerating - currentGenerating < count) {
+		count = maxGenerating - currentGenerating;
+	}
 
-	Direction direction;
-	for (unsigned short nthDimension = 2; nthDimension <= dimensions; ++nthDimension) {
-		direction = globalNewJoeKuo621201.directions[nthDimension - 2]; // direction data store dimension data start by 2 --Zachary
-		if (requiredBits <= direction.degree) {
-			for (unsigned int i = 1; i <= requiredBits; ++i) {
-				V[i] = direction.initialDirections[i - 1] << (32 - i);
+	for (Word i = 0; i < count; ++i) {
+		const Word *directionRow = Advance();
+		if (SobolLayout::PointMajor == layout) {
+			double *point = points + (size_t)i * dimensions;
+			if (nullptr == directionRow) {
+				ToUnit(previousXByDimension, point);
+			}
+			else if (SobolScrambling::None == scrambling) {
+				SobolKernels::XorToUnit(previousXByDimension, directionRow, point, dimensions);
+			}
+			else {
+				SobolKernels::Xor(previousXByDimension, directionRow, dimensions);
+				ToUnit(previousXByDimension, point);
 			}
 		}
 		else {
-			for (unsigned char i = 1; i <= direction.degree; ++i) {
-				V[i] = direction.initialDirections[i - 1] << (32 - i);
+			if (nullptr != directionRow) {
+				SobolKernels::Xor(previousXByDimension, directionRow, dimensions);
 			}
-			for (unsigned int i = direction.degree + 1; i <= requiredBits; ++i) {
-				V[i] = V[i - direction.degree] ^ (V[i - direction.degree] >> direction.degree);
-				for (unsigned char k = 1; k <= direction.degree - 1; ++k) {
-					V[i] ^= (((direction.coefficients >> (direction.degree - 1 - k)) & 1) * V[i - k]);
-				}
+			for (unsigned short j = 0; j < dimensions; ++j) {
+				points[j * dimensionStride + (size_t)i] = ToUnit(previousXByDimension[j], j);
 			}
 		}
+	}
+	return count;
+}
 
-		X = previousXByDimension[nthDimension - 1] ^ V[previousC];
-		point.push_back((double)X / dividend);
-		previousXByDimension[nthDimension - 1] = X;
+template <typename Word>
+template <typename Output, typename ConvertPoint, typename ConvertValue>
+Word BasicSobolGenerator<Word>::GetConvertedBlock(Output *points, Word count, SobolLayout layout, size_t dimensionStride, ConvertPoint convertPoint, ConvertValue convertValue) {
+	if (0 == dimensionStride) {
+		dimensionStride = (size_t)count;
+	}
+	if (maxGenerating - currentGenerating < count) {
+		count = maxGenerating - currentGenerating;
 	}
 
-	previousC = C;
-	++currentGenerating;
+	for (Word i = 0; i < count; ++i) {
+		const Word *directionRow = Advance();
+		if (nullptr != directionRow) {
+			SobolKernels::Xor(previousXByDimension, directionRow, dimensions);
+		}
+		const Word *X = GetScrambledX();
+		if (SobolLayout::PointMajor == layout) {
+			convertPoint(X, points + (size_t)i * dimensions);
+		}
+		else {
+			for (unsigned short j = 0; j < dimensions; ++j) {
+				points[j * dimensionStride + (size_t)i] = convertValue(X[j], j);
+			}
+		}
+	}
+	return count;
+}
+
+template <typename Word>
+Word BasicSobolGenerator<Word>::GetBlock(Word *points, Word count, SobolLayout layout, size_t dimensionStride) {
+	const unsigned short dimensions = this->dimensions;
+	return GetConvertedBlock(points, count, layout, dimensionStride,
+		[dimensions](const Word *X, Word *point) { memcpy(point, X, sizeof(Word) * dimensions); },
+		[](Word X, unsigned short) { return X; });
+}
+
+template <typename Word>
+Word BasicSobolGenerator<Word>::GetBlock(float *points, Word count, SobolLayout layout, size_t dimensionStride) {
+	const unsigned short dimensions = this->dimensions;
+	return GetConvertedBlock(points, count, layout, dimensionStride,
+		[dimensions](const Word *X, float *point) { SobolKernels::ToFloat(X, point, dimensions); },
+		[](Word X, unsigned short) { return SobolWord<Word>::ToFloat(X); });
+}
+
+template <typename Word>
+Word BasicSobolGenerator<Word>::GetGridBlock(uint16_t *cells, Word count, const uint32_t *resolutions, SobolLayout layout, size_t dimensionStride) {
+	const unsigned short dimensions = this->dimensions;
+	return GetConvertedBlock(cells, count, layout, dimensionStride,
+		[dimensions, resolutions](const Word *X, uint16_t *cell) { SobolKernels::ToGrid(X, resolutions, cell, dimensions); },
+		[resolutions](Word X, unsigned short j) { return SobolWord<Word>::ToGrid(X, resolutions[j]); });
+}
+
+// The point at index is the XOR of the direction numbers V[i] for every bit i set in the Gray code of index,
+// collects those direction rows and returns how many there are.
+template <typename Word>
+unsigned int BasicSobolGenerator<Word>::GetRows(Word mask, const Word **rows) const {
+	unsigned int rowCount = 0;
+	for (unsigned int i = 1; 0 != mask; ++i, mask >>= 1) {
+		if (mask & 1) {
+			rows[rowCount++] = V + i * dimensions;
+		}
+	}
+	return rowCount;
+}
+
+template <typename Word>
+bool BasicSobolGenerator<Word>::Seek(Word index) {
+	if (index > maxGenerating) {
+		return false;
+	}
+
+	currentGenerating = index;
+	memset(previousXByDimension, 0, sizeof(Word) * dimensions);
+	if (0 == index) {
+		previousC = 1;
+		return true;
+	}
+
+	// The state carries the point before index and the bit to flip to reach index from it.
+	Reserve(index);
+	const Word *rows[Bits];
+	unsigned int rowCount = GetGrayCodeRows(index - 1, rows);
+	for (unsigned int i = 0; i < rowCount; ++i) {
+		SobolKernels::Xor(previousXByDimension, rows[i], dimensions);
+	}
+	previousC = SobolRightmostZeroBit(index - 1);
 	return true;
 }
 
-SobolGenerator::~SobolGenerator() {
+template <typename Word>
+bool BasicSobolGenerator<Word>::PointAt(Word index, double *point) const {
+	if (index >= GetCovered()) {
+		return false;
+	}
+
+	const Word *rows[Bits];
+	unsigned int rowCount = GetGrayCodeRows(index, rows);
+	for (unsigned short j = 0; j < dimensions; ++j) {
+		Word X = 0;
+		for (unsigned int i = 0; i < rowCount; ++i) {
+			X ^= rows[i][j];
+		}
+		point[j] = ToUnit(X, j);
+	}
+	return true;
+}
+
+template <typename Word>
+bool BasicSobolGenerator<Word>::PointAt(Word index, vector<double>& point) const {
+	if (index >= GetCovered()) {
+		return false;
+	}
+
+	auto offset = point.size();
+	point.resize(offset + dimensions);
+	return PointAt(index, point.data() + offset);
+}
+
+template <typename Word>
+Word BasicSobolGenerator<Word>::GetDimension(unsigned short dimension, Word begin, Word count, double *values) const {
+	const Word covered = GetCovered();
+	if (dimension >= dimensions || begin >= covered) {
+		return 0;
+	}
+	if (covered - begin < count) {
+		count = covered - begin;
+	}
+
+	// Gather the direction numbers of this dimension out of the bit-major matrix so the loops below stay in cache.
+	// The rows past requiredBits stay 0, the table below may reach them for points past the sequence it never uses.
+	Word column[Bits + 1] = {};
+	for (unsigned int i = 1; i <= requiredBits; ++i) {
+		column[i] = V[i * dimensions + dimension];
+	}
+
+	// A digital shift commutes with the XORs of the recurrence, so it is applied to the starting word of every run.
+	const Word key = scrambleKeys[dimension];
+	auto wordAt = [&](Word index) {
+		Word X = SobolScrambling::DigitalShift == scrambling ? key : 0, grayCode = index ^ (index >> 1);
+		for (unsigned int i = 1; 0 != grayCode; ++i, grayCode >>= 1) {
+			if (grayCode & 1) {
+				X ^= column[i];
+			}
+		}
+		return X;
+	};
+
+	// When a is a multiple of pieceSize and k < pieceSize, the Gray code of a + k is that of a XOR that of k, so the
+	// point a + k is the point a XOR the point k. Every aligned piece of the column is then its starting word XORed
+	// with the table of the first words, a branchless loop the compiler vectorizes, and the words are converted in
+	// one pass by the vector kernels.
+	const unsigned int pieceSize = 256;
+	const unsigned int tableSize = count < pieceSize ? (unsigned int)count : pieceSize;
+	Word table[pieceSize], words[pieceSize], keys[pieceSize];
+	table[0] = 0;
+	for (unsigned int k = 1; k < tableSize; ++k) {
+		table[k] = table[k - 1] ^ column[SobolRightmostZeroBit((Word)(k - 1))];
+	}
+	const bool isOwen = SobolScrambling::Owen == scrambling;
+	if (isOwen) {
+		for (unsigned int k = 0; k < pieceSize; ++k) {
+			keys[k] = key;
+		}
+	}
+	auto convert = [&](Word i, unsigned int n) {
+		if (isOwen) {
+			SobolKernels::OwenToUnit(words, keys, values + i, n);
+		}
+		else {
+			SobolKernels::ToUnit(words, values + i, n);
+		}
+	};
+
+	// Steps one point at a time up to the first multiple of pieceSize.
+	Word head = (Word)(pieceSize - begin % pieceSize) % pieceSize;
+	if (head > count) {
+		head = count;
+	}
+	if (0 < head) {
+		Word X = wordAt(begin);
+		words[0] = X;
+		for (unsigned int k = 1; k < head; ++k) {
+			X ^= column[SobolRightmostZeroBit((Word)(begin + k - 1))];
+			words[k] = X;
+		}
+		convert(0, (unsigned int)head);
+	}
+	for (Word i = head; i < count; i += pieceSize) {
+		const unsigned int n = count - i < pieceSize ? (unsigned int)(count - i) : pieceSize;
+		const Word X = wordAt(begin + i);
+		for (unsigned int k = 0; k < n; ++k) {
+			words[k] = X ^ table[k];
+		}
+		convert(i, n);
+	}
+	return count;
+}
+
+template <typename Word>
+BasicSobolGenerator<Word>::~BasicSobolGenerator() {
 	delete[] V;
 	delete[] previousXByDimension;
-}
\ No newline at end of file
+	delete[] scrambleKeys;
+	delete[] scrambledX;
+}
+
+template void ComputeDirectionNumbers<uint32_t>(const DirectionSet&, unsigned short, unsigned int, uint32_t *, size_t);
+template void ComputeDirectionNumbers<uint64_t>(const DirectionSet&, unsigned short, unsigned int, uint64_t *, size_t);
+template class BasicSobolGenerator<uint32_t>;
+template class BasicSobolGenerator<uint64_t>;
\ No newline at end of file
@@ -5,24 +5,190 @@
 
 #include <cstdarg>
 #include <cmath>
+#include <cstdint>
 
 #include <vector>
 #include "SobolDirection.h"
+#include "SobolKernels.h"
 
 using namespace std;
 
-class SobolGenerator {
+// Memory layout of a block of points.
+enum class SobolLayout {
+	// points[i * dimensions + j] is the jth component of the ith point
+	PointMajor,
+	// points[j * count + i] is the jth component of the ith point
+	DimensionMajor
+};
+
+// Randomization applied to the points on output, see BasicSobolGenerator::Scramble. Both keep the stratification
+// of the sequence, points of different seeds are decorrelated.
+enum class SobolScrambling {
+	None,
+	// Every coordinate is XORed with a random word of its dimension.
+	DigitalShift,
+	// Nested uniform scrambling, see SobolKernels::OwenScramble. Also randomizes the bits below the resolution of
+	// the point set, which a digital shift only translates.
+	Owen
+};
+
+// Properties of the machine word a generator computes with. The direction numbers and the points are scaled by
+// 2^Bits, so the word bounds both the sequence length (2^Bits points) and the precision of the output.
+template <typename Word>
+struct SobolWord;
+
+template <>
+struct SobolWord<uint32_t> {
+	static const unsigned int Bits = 32;
+	static double ToUnit(uint32_t X) { return (double)X / 4294967296.0; }
+	// From the 24 high bits, a float has no more and rounding the full word could give 1.
+	static float ToFloat(uint32_t X) { return (float)(X >> 8) / 16777216.0f; }
+	static uint16_t ToGrid(uint32_t X, uint32_t resolution) { return (uint16_t)(((uint64_t)X * resolution) >> 32); }
+};
+
+template <>
+struct SobolWord<uint64_t> {
+	static const unsigned int Bits = 64;
+	// A double only carries 53 bits, drop the low ones first so the conversion is exact.
+	static double ToUnit(uint64_t X) { return (double)(X >> 11) / 9007199254740992.0; }
+	static float ToFloat(uint64_t X) { return (float)(X >> 40) / 16777216.0f; }
+	static uint16_t ToGrid(uint64_t X, uint32_t resolution) { return SobolWord<uint32_t>::ToGrid((uint32_t)(X >> 32), resolution); }
+};
+
+// C = index from the right of the first zero bit of value, the direction number to XOR in to step from point value to
+// point value + 1 in Gray code order.
+template <typename Word>
+inline unsigned int SobolRightmostZeroBit(Word value) {
+	unsigned int C = 1;
+	while (value & 1) {
+		value >>= 1;
+		C++;
+	}
+	return C;
+}
+
+// Scrambling key of a dimension for a seed, the SplitMix64 finalizer of both.
+template <typename Word>
+inline Word SobolScrambleKey(uint64_t seed, unsigned short dimension) {
+	uint64_t z = seed + (uint64_t)(dimension + 1) * 0x9e3779b97f4a7c15u;
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+	return (Word)(z ^ (z >> 31));
+}
+
+// Scrambles one scaled coordinate X with the key of its dimension.
+template <typename Word>
+inline Word SobolScramble(SobolScrambling scrambling, Word X, Word key) {
+	if (SobolScrambling::DigitalShift == scrambling) {
+		return X ^ key;
+	}
+	if (SobolScrambling::Owen == scrambling) {
+		return SobolKernels::OwenScramble(X, key);
+	}
+	return X;
+}
+
+// Computes the direction numbers V[1] to V[bits] of dimension nthDimension (1 based) from directionSet, scaled by
+// 2^SobolWord<Word>::Bits, into column[i * stride].
+template <typename Word>
+void ComputeDirectionNumbers(const DirectionSet& directionSet, unsigned short nthDimension, unsigned int bits, Word *column, size_t stride);
+
+// Tag picking the open-ended constructor of BasicSobolGenerator and the generators built on it.
+struct SobolUnbounded {
+};
+
+// Sobol sequence generator over a machine word. Instantiated for uint32_t (SobolGenerator), the fast path, and
+// uint64_t (SobolGenerator64) for sequences longer than 2^32 points and outputs with a full 53 bit mantissa.
+template <typename Word>
+class BasicSobolGenerator {
 public:
-	SobolGenerator(unsigned int maxGenerating, unsigned short dimensions);
-	~SobolGenerator();
+	static const unsigned int Bits = SobolWord<Word>::Bits;
+
+	// dimensions must not exceed directionSet.dimensions. A maxGenerating of 0 gives an empty sequence.
+	BasicSobolGenerator(Word maxGenerating, unsigned short dimensions, const DirectionSet& directionSet = globalNewJoeKuo621201);
+	// Open-ended sequence, as many points as the word can index. The direction numbers start empty and gain one bit
+	// each time the index crosses a power of two, and directionSet must outlive the generator.
+	BasicSobolGenerator(SobolUnbounded, unsigned short dimensions, const DirectionSet& directionSet = globalNewJoeKuo621201);
+	BasicSobolGenerator(const BasicSobolGenerator& other);
+	~BasicSobolGenerator();
+	BasicSobolGenerator& operator=(const BasicSobolGenerator&) = delete;
+
+	Word GetMaxGenerating() const { return maxGenerating; }
+	unsigned short GetDimensions() const { return dimensions; }
+	bool IsUnbounded() const { return nullptr != directionSet; }
+	// Makes sure the direction numbers cover the points [0, count), which an unbounded generator otherwise only does
+	// once it reaches them. Needed before PointAt or GetDimension read points ahead of it, as those are const and do
+	// not grow the direction numbers. Returns false when count is past maxGenerating.
+	bool Reserve(Word count);
+	// Randomizes every point returned from now on with keys derived from seed, typically one seed per map.
+	// SobolScrambling::None goes back to the plain sequence.
+	void Scramble(SobolScrambling scrambling, uint64_t seed = 0);
+	SobolScrambling GetScrambling() const { return scrambling; }
 	bool GetNext(vector<double>& point);
+	// Writes up to count following points into points, which must hold count * dimensions values.
+	// Returns the number of points written, less than count only when the sequence is exhausted.
+	// With SobolLayout::DimensionMajor the jth component of the ith point goes to points[j * dimensionStride + i],
+	// dimensionStride defaults to count.
+	Word GetBlock(double *points, Word count, SobolLayout layout = SobolLayout::PointMajor, size_t dimensionStride = 0);
+	// Same as above with narrower outputs, which skip the conversion to double and the memory traffic that goes
+	// with it. The Word overload writes the scaled coordinates themselves, x * 2^Bits, the float one the 24 high
+	// bits of them so every value is exact and below 1.
+	Word GetBlock(Word *points, Word count, SobolLayout layout = SobolLayout::PointMajor, size_t dimensionStride = 0);
+	Word GetBlock(float *points, Word count, SobolLayout layout = SobolLayout::PointMajor, size_t dimensionStride = 0);
+	// Same as GetBlock, but writes the cell of each coordinate on a grid of resolutions[j] cells along dimension j,
+	// floor(x * resolutions[j]) computed on the integer. Resolutions must not exceed 65536.
+	Word GetGridBlock(uint16_t *cells, Word count, const uint32_t *resolutions, SobolLayout layout = SobolLayout::PointMajor, size_t dimensionStride = 0);
+	// Positions the generator so that the next point returned is the one at index, in O(requiredBits * dimensions).
+	// Returns false, leaving the generator untouched, when index is past maxGenerating.
+	bool Seek(Word index);
+	// Computes the point at index directly from the Gray code of index without touching the generator state.
+	// An unbounded generator only reaches the points its direction numbers cover, see Reserve.
+	bool PointAt(Word index, vector<double>& point) const;
+	bool PointAt(Word index, double *point) const;
+	// Computes only the given (0 based) dimension of the points [begin, begin + count) into values, independently
+	// of the generator state and of every other dimension. Returns the number of values written.
+	Word GetDimension(unsigned short dimension, Word begin, Word count, double *values) const;
 
 private:
-	unsigned int maxGenerating, currentGenerating;
+	template <typename> friend class BasicSobolStream;
+
+	BasicSobolGenerator(Word maxGenerating, unsigned short dimensions, const DirectionSet& directionSet, bool isUnbounded);
+	void InitDirectionNumbers(const DirectionSet& directionSet);
+	// Recomputes the direction numbers of an unbounded generator with the given depth.
+	void Grow(unsigned int bits);
+	// Number of points the direction numbers computed so far cover.
+	Word GetCovered() const;
+	const Word *Advance();
+	// Shared loop of the GetBlock overloads but the double one: convertPoint converts the (scrambled) coordinates
+	// of a whole point, convertValue those of a single dimension for the dimension-major layout.
+	template <typename Output, typename ConvertPoint, typename ConvertValue>
+	Word GetConvertedBlock(Output *points, Word count, SobolLayout layout, size_t dimensionStride, ConvertPoint convertPoint, ConvertValue convertValue);
+	// The current point with the scrambling applied, previousXByDimension itself when there is none.
+	const Word *GetScrambledX();
+	// Converts the scaled coordinates of a point, or a single one of a dimension, applying the scrambling.
+	void ToUnit(const Word *X, double *point) const;
+	double ToUnit(Word X, unsigned short dimension) const { return SobolWord<Word>::ToUnit(SobolScramble(scrambling, X, scrambleKeys[dimension])); }
+	// Collects the rows of V to XOR together for the bits set in mask, returns how many.
+	unsigned int GetRows(Word mask, const Word **rows) const;
+	unsigned int GetGrayCodeRows(Word index, const Word **rows) const { return GetRows(index ^ (index >> 1), rows); }
+
+	Word maxGenerating, currentGenerating;
 	unsigned short dimensions;
 	unsigned int requiredBits;
-	unsigned int *V;
-	unsigned int previousC, *previousXByDimension;
+	// Direction numbers of every dimension, scaled by 2^Bits and stored bit-major:
+	// V[i * dimensions + j] is V[i] of dimension j + 1, for i in [1, requiredBits]. Row 0 is unused.
+	Word *V;
+	// Only kept by an unbounded generator, to grow V.
+	const DirectionSet *directionSet;
+	unsigned int previousC;
+	Word *previousXByDimension;
+	SobolScrambling scrambling;
+	Word *scrambleKeys;
+	// Scratch for GetScrambledX, allocated along with the first scrambling.
+	Word *scrambledX;
 };
 
+typedef BasicSobolGenerator<uint32_t> SobolGenerator;
+typedef BasicSobolGenerator<uint64_t> SobolGenerator64;
+
 #endif //SOBOL_GENERATOR_H
\ No newline at end of file
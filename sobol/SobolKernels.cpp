@@ -0,0 +1,542 @@
+#include "pch.h"
+
+#include "SobolKernels.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SOBOL_KERNELS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SOBOL_TARGET_SSE2
+#define SOBOL_TARGET_AVX2
+#else
+#define SOBOL_TARGET_SSE2 __attribute__((target("sse2")))
+#define SOBOL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+	const double inverseDividend32 = 1.0 / 4294967296.0;
+	const double inverseDividend53 = 1.0 / 9007199254740992.0;
+
+	inline double ToUnitScalar(uint32_t x) {
+		return (double)x * inverseDividend32;
+	}
+
+	inline double ToUnitScalar(uint64_t x) {
+		return (double)(x >> 11) * inverseDividend53;
+	}
+
+	template <typename Word>
+	void XorScalar(Word *x, const Word *v, unsigned int n) {
+		for (unsigned int i = 0; i < n; ++i) {
+			x[i] ^= v[i];
+		}
+	}
+
+	template <typename Word>
+	void ToUnitScalar(const Word *x, double *out, unsigned int n) {
+		for (unsigned int i = 0; i < n; ++i) {
+			out[i] = ToUnitScalar(x[i]);
+		}
+	}
+
+	template <typename Word>
+	void XorToUnitScalar(Word *x, const Word *v, double *out, unsigned int n) {
+		for (unsigned int i = 0; i < n; ++i) {
+			x[i] ^= v[i];
+			out[i] = ToUnitScalar(x[i]);
+		}
+	}
+
+	inline float ToFloatScalar(uint32_t x) {
+		return (float)(x >> 8) * (1.0f / 16777216.0f);
+	}
+
+	inline float ToFloatScalar(uint64_t x) {
+		return (float)(x >> 40) * (1.0f / 16777216.0f);
+	}
+
+	inline uint16_t ToGridScalar(uint32_t x, uint32_t resolution) {
+		return (uint16_t)(((uint64_t)x * resolution) >> 32);
+	}
+
+	inline uint16_t ToGridScalar(uint64_t x, uint32_t resolution) {
+		return ToGridScalar((uint32_t)(x >> 32), resolution);
+	}
+
+	template <typename Word>
+	void ToFloatScalar(const Word *x, float *out, unsigned int n) {
+		for (unsigned int i = 0; i < n; ++i) {
+			out[i] = ToFloatScalar(x[i]);
+		}
+	}
+
+	template <typename Word>
+	void ToGridScalar(const Word *x, const uint32_t *resolutions, uint16_t *out, unsigned int n) {
+		for (unsigned int i = 0; i < n; ++i) {
+			out[i] = ToGridScalar(x[i], resolutions[i]);
+		}
+	}
+
+	template <typename Word>
+	void ShiftToUnitScalar(const Word *x, const Word *keys, double *out, unsigned int n) {
+		for (unsigned int i = 0; i < n; ++i) {
+			out[i] = ToUnitScalar((Word)(x[i] ^ keys[i]));
+		}
+	}
+
+	template <typename Word>
+	void OwenToUnitScalar(const Word *x, const Word *keys, double *out, unsigned int n) {
+		for (unsigned int i = 0; i < n; ++i) {
+			out[i] = ToUnitScalar(SobolKernels::OwenScramble(x[i], keys[i]));
+		}
+	}
+
+#ifdef SOBOL_KERNELS_X86
+	// There is no unsigned 32 bit to double conversion before AVX-512, so the values are biased into the signed
+	// range, converted, and the bias is added back. Every step is exact.
+	SOBOL_TARGET_SSE2 inline void StoreUnitSSE2(__m128i x, double *out) {
+		const __m128i signBit = _mm_set1_epi32((int)0x80000000);
+		const __m128d bias = _mm_set1_pd(2147483648.0);
+		const __m128d scale = _mm_set1_pd(inverseDividend32);
+		__m128i biased = _mm_xor_si128(x, signBit);
+		__m128d low = _mm_cvtepi32_pd(biased);
+		__m128d high = _mm_cvtepi32_pd(_mm_shuffle_epi32(biased, _MM_SHUFFLE(1, 0, 3, 2)));
+		_mm_storeu_pd(out, _mm_mul_pd(_mm_add_pd(low, bias), scale));
+		_mm_storeu_pd(out + 2, _mm_mul_pd(_mm_add_pd(high, bias), scale));
+	}
+
+	// Nor is there a 64 bit one. After dropping to 53 bits the value is split into its high 21 and low 32 bits,
+	// each is planted in the mantissa of a double with a known exponent (2^84 and 2^52), and the exponents are
+	// subtracted away. Again every step is exact.
+	SOBOL_TARGET_SSE2 inline void StoreUnitSSE2(__m128i x, double *out, int) {
+		const __m128i lowMask = _mm_set1_epi64x(0xFFFFFFFF);
+		const __m128i exponent52 = _mm_castpd_si128(_mm_set1_pd(4503599627370496.0));
+		const __m128i exponent84 = _mm_castpd_si128(_mm_set1_pd(19342813113834066795298816.0));
+		const __m128d exponents = _mm_set1_pd(19342813118337666422669312.0);
+		x = _mm_srli_epi64(x, 11);
+		__m128d high = _mm_castsi128_pd(_mm_or_si128(_mm_srli_epi64(x, 32), exponent84));
+		__m128d low = _mm_castsi128_pd(_mm_or_si128(_mm_and_si128(x, lowMask), exponent52));
+		__m128d value = _mm_add_pd(_mm_sub_pd(high, exponents), low);
+		_mm_storeu_pd(out, _mm_mul_pd(value, _mm_set1_pd(inverseDividend53)));
+	}
+
+	// XOR is the same for any word size, the loops just see bytes.
+	SOBOL_TARGET_SSE2 void XorBytesSSE2(unsigned char *x, const unsigned char *v, size_t bytes) {
+		for (size_t i = 0; i < bytes; i += 16) {
+			__m128i value = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(x + i)), _mm_loadu_si128((const __m128i *)(v + i)));
+			_mm_storeu_si128((__m128i *)(x + i), value);
+		}
+	}
+
+	template <typename Word>
+	SOBOL_TARGET_SSE2 void XorSSE2(Word *x, const Word *v, unsigned int n) {
+		const unsigned int lanes = 16 / sizeof(Word);
+		unsigned int vectorized = n - n % lanes;
+		XorBytesSSE2((unsigned char *)x, (const unsigned char *)v, vectorized * sizeof(Word));
+		XorScalar(x + vectorized, v + vectorized, n - vectorized);
+	}
+
+	SOBOL_TARGET_SSE2 void ToUnitSSE2(const uint32_t *x, double *out, unsigned int n) {
+		unsigned int i = 0;
+		for (; i + 4 <= n; i += 4) {
+			StoreUnitSSE2(_mm_loadu_si128((const __m128i *)(x + i)), out + i);
+		}
+		ToUnitScalar(x + i, out + i, n - i);
+	}
+
+	SOBOL_TARGET_SSE2 void ToUnitSSE2(const uint64_t *x, double *out, unsigned int n) {
+		unsigned int i = 0;
+		for (; i + 2 <= n; i += 2) {
+			StoreUnitSSE2(_mm_loadu_si128((const __m128i *)(x + i)), out + i, 0);
+		}
+		ToUnitScalar(x + i, out + i, n - i);
+	}
+
+	SOBOL_TARGET_SSE2 void XorToUnitSSE2(uint32_t *x, const uint32_t *v, double *out, unsigned int n) {
+		unsigned int i = 0;
+		for (; i + 4 <= n; i += 4) {
+			__m128i value = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(x + i)), _mm_loadu_si128((const __m128i *)(v + i)));
+			_mm_storeu_si128((__m128i *)(x + i), value);
+			StoreUnitSSE2(value, out + i);
+		}
+		XorToUnitScalar(x + i, v + i, out + i, n - i);
+	}
+
+	SOBOL_TARGET_SSE2 void XorToUnitSSE2(uint64_t *x, const uint64_t *v, double *out, unsigned int n) {
+		unsigned int i = 0;
+		for (; i + 2 <= n; i += 2) {
+			__m128i value = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(x + i)), _mm_loadu_si128((const __m128i *)(v + i)));
+			_mm_storeu_si128((__m128i *)(x + i), value);
+			StoreUnitSSE2(value, out + i, 0);
+		}
+		XorToUnitScalar(x + i, v + i, out + i, n - i);
+	}
+
+	SOBOL_TARGET_SSE2 void ToFloatSSE2(const uint32_t *x, float *out, unsigned int n) {
+		const __m128 scale = _mm_set1_ps(1.0f / 16777216.0f);
+		unsigned int i = 0;
+		for (; i + 4 <= n; i += 4) {
+			__m128i value = _mm_srli_epi32(_mm_loadu_si128((const __m128i *)(x + i)), 8);
+			_mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(value), scale));
+		}
+		ToFloatScalar(x + i, out + i, n - i);
+	}
+
+	SOBOL_TARGET_SSE2 void ShiftToUnitSSE2(const uint32_t *x, const uint32_t *keys, double *out, unsigned int n) {
+		unsigned int i = 0;
+		for (; i + 4 <= n; i += 4) {
+			StoreUnitSSE2(_mm_xor_si128(_mm_loadu_si128((const __m128i *)(x + i)), _mm_loadu_si128((const __m128i *)(keys + i))), out + i);
+		}
+		ShiftToUnitScalar(x + i, keys + i, out + i, n - i);
+	}
+
+	SOBOL_TARGET_SSE2 void ShiftToUnitSSE2(const uint64_t *x, const uint64_t *keys, double *out, unsigned int n) {
+		unsigned int i = 0;
+		for (; i + 2 <= n; i += 2) {
+			StoreUnitSSE2(_mm_xor_si128(_mm_loadu_si128((const __m128i *)(x + i)), _mm_loadu_si128((const __m128i *)(keys + i))), out + i, 0);
+		}
+		ShiftToUnitScalar(x + i, keys + i, out + i, n - i);
+	}
+
+	// SSE2 has neither a 32 bit low multiply nor a byte shuffle: the multiply is put together from two 32 x 32 -> 64
+	// bit ones on the even and odd lanes, and the bits are reversed with the same masks as the scalar code.
+	SOBOL_TARGET_SSE2 inline __m128i MultiplySSE2(__m128i a, __m128i b) {
+		__m128i even = _mm_mul_epu32(a, b);
+		__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	}
+
+	SOBOL_TARGET_SSE2 inline __m128i SwapBitsSSE2(__m128i x, int shift, uint32_t mask) {
+		const __m128i masks = _mm_set1_epi32((int)mask);
+		__m128i shift128 = _mm_cvtsi32_si128(shift);
+		return _mm_or_si128(_mm_and_si128(_mm_srl_epi32(x, shift128), masks), _mm_sll_epi32(_mm_and_si128(x, masks), shift128));
+	}
+
+	SOBOL_TARGET_SSE2 inline __m128i ReverseBitsSSE2(__m128i x) {
+		x = SwapBitsSSE2(x, 1, 0x55555555u);
+		x = SwapBitsSSE2(x, 2, 0x33333333u);
+		x = SwapBitsSSE2(x, 4, 0x0F0F0F0Fu);
+		x = SwapBitsSSE2(x, 8, 0x00FF00FFu);
+		return _mm_or_si128(_mm_srli_epi32(x, 16), _mm_slli_epi32(x, 16));
+	}
+
+	SOBOL_TARGET_SSE2 void OwenToUnitSSE2(const uint32_t *x, const uint32_t *keys, double *out, unsigned int n) {
+		const __m128i one = _mm_set1_epi32(1);
+		unsigned int i = 0;
+		for (; i + 4 <= n; i += 4) {
+			__m128i seed = _mm_loadu_si128((const __m128i *)(keys + i));
+			__m128i value = ReverseBitsSSE2(_mm_loadu_si128((const __m128i *)(x + i)));
+			value = _mm_xor_si128(value, MultiplySSE2(value, _mm_set1_epi32(0x3d20adea)));
+			value = _mm_add_epi32(value, seed);
+			value = MultiplySSE2(value, _mm_or_si128(_mm_srli_epi32(seed, 16), one));
+			value = _mm_xor_si128(value, MultiplySSE2(value, _mm_set1_epi32(0x05526c56)));
+			value = _mm_xor_si128(value, MultiplySSE2(value, _mm_set1_epi32(0x53a22864)));
+			StoreUnitSSE2(ReverseBitsSSE2(value), out + i);
+		}
+		OwenToUnitScalar(x + i, keys + i, out + i, n - i);
+	}
+
+	SOBOL_TARGET_AVX2 inline void StoreUnitAVX2(__m256i x, double *out) {
+		const __m256i signBit = _mm256_set1_epi32((int)0x80000000);
+		const __m256d bias = _mm256_set1_pd(2147483648.0);
+		const __m256d scale = _mm256_set1_pd(inverseDividend32);
+		__m256i biased = _mm256_xor_si256(x, signBit);
+		__m256d low = _mm256_cvtepi32_pd(_mm256_castsi256_si128(biased));
+		__m256d high = _mm256_cvtepi32_pd(_mm256_extracti128_si256(biased, 1));
+		_mm256_storeu_pd(out, _mm256_mul_pd(_mm256_add_pd(low, bias), scale));
+		_mm256_storeu_pd(out + 4, _mm256_mul_pd(_mm256_add_pd(high, bias), scale));
+	}
+
+	SOBOL_TARGET_AVX2 inline void StoreUnitAVX2(__m256i x, double *out, int) {
+		const __m256i exponent52 = _mm256_castpd_si256(_mm256_set1_pd(4503599627370496.0));
+		const __m256i exponent84 = _mm256_castpd_si256(_mm256_set1_pd(19342813113834066795298816.0));
+		const __m256d exponents = _mm256_set1_pd(19342813118337666422669312.0);
+		x = _mm256_srli_epi64(x, 11);
+		__m256d high = _mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(x, 32), exponent84));
+		__m256d low = _mm256_castsi256_pd(_mm256_blend_epi32(x, exponent52, 0xAA));
+		__m256d value = _mm256_add_pd(_mm256_sub_pd(high, exponents), low);
+		_mm256_storeu_pd(out, _mm256_mul_pd(value, _mm256_set1_pd(inverseDividend53)));
+	}
+
+	SOBOL_TARGET_AVX2 void XorBytesAVX2(unsigned char *x, const unsigned char *v, size_t bytes) {
+		for (size_t i = 0; i < bytes; i += 32) {
+			__m256i value = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(x + i)), _mm256_loadu_si256((const __m256i *)(v + i)));
+			_mm256_storeu_si256((__m256i *)(x + i), value);
+		}
+	}
+
+	template <typename Word>
+	SOBOL_TARGET_AVX2 void XorAVX2(Word *x, const Word *v, unsigned int n) {
+		const unsigned int lanes = 32 / sizeof(Word);
+		unsigned int vectorized = n - n % lanes;
+		XorBytesAVX2((unsigned char *)x, (const unsigned char *)v, vectorized * sizeof(Word));
+		XorScalar(x + vectorized, v + vectorized, n - vectorized);
+	}
+
+	SOBOL_TARGET_AVX2 void ToUnitAVX2(const uint32_t *x, double *out, unsigned int n) {
+		unsigned int i = 0;
+		for (; i + 8 <= n; i += 8) {
+			StoreUnitAVX2(_mm256_loadu_si256((const __m256i *)(x + i)), out + i);
+		}
+		ToUnitScalar(x + i, out + i, n - i);
+	}
+
+	SOBOL_TARGET_AVX2 void ToUnitAVX2(const uint64_t *x, double *out, unsigned int n) {
+		unsigned int i = 0;
+		for (; i + 4 <= n; i += 4) {
+			StoreUnitAVX2(_mm256_loadu_si256((const __m256i *)(x + i)), out + i, 0);
+		}
+		ToUnitScalar(x + i, out + i, n - i);
+	}
+
+	SOBOL_TARGET_AVX2 void XorToUnitAVX2(uint32_t *x, const uint32_t *v, double *out, unsigned int n) {
+		unsigned int i = 0;
+		for (; i + 8 <= n; i += 8) {
+			__m256i value = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(x + i)), _mm256_loadu_si256((const __m256i *)(v + i)));
+			_mm256_storeu_si256((__m256i *)(x + i), value);
+			StoreUnitAVX2(value, out + i);
+		}
+		XorToUnitScalar(x + i, v + i, out + i, n - i);
+	}
+
+	SOBOL_TARGET_AVX2 void XorToUnitAVX2(uint64_t *x, const uint64_t *v, double *out, unsigned int n) {
+		unsigned int i = 0;
+		for (; i + 4 <= n; i += 4) {
+			__m256i value = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(x + i)), _mm256_loadu_si256((const __m256i *)(v + i)));
+			_mm256_storeu_si256((__m256i *)(x + i), value);
+			StoreUnitAVX2(value, out + i, 0);
+		}
+		XorToUnitScalar(x + i, v + i, out + i, n - i);
+	}
+
+	SOBOL_TARGET_AVX2 void ToFloatAVX2(const uint32_t *x, float *out, unsigned int n) {
+		const __m256 scale = _mm256_set1_ps(1.0f / 16777216.0f);
+		unsigned int i = 0;
+		for (; i + 8 <= n; i += 8) {
+			__m256i value = _mm256_srli_epi32(_mm256_loadu_si256((const __m256i *)(x + i)), 8);
+			_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(value), scale));
+		}
+		ToFloatScalar(x + i, out + i, n - i);
+	}
+
+	// The high halves of the 32 x 32 -> 64 bit products of the even and of the odd lanes are merged back into one
+	// vector, then narrowed to 16 bits. packus works within each 128 bit half, hence the final permute.
+	SOBOL_TARGET_AVX2 void ToGridAVX2(const uint32_t *x, const uint32_t *resolutions, uint16_t *out, unsigned int n) {
+		unsigned int i = 0;
+		for (; i + 8 <= n; i += 8) {
+			__m256i value = _mm256_loadu_si256((const __m256i *)(x + i));
+			__m256i resolution = _mm256_loadu_si256((const __m256i *)(resolutions + i));
+			__m256i even = _mm256_srli_epi64(_mm256_mul_epu32(value, resolution), 32);
+			__m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(value, 32), _mm256_srli_epi64(resolution, 32));
+			__m256i cells = _mm256_blend_epi32(even, odd, 0xAA);
+			cells = _mm256_permute4x64_epi64(_mm256_packus_epi32(cells, cells), _MM_SHUFFLE(3, 1, 2, 0));
+			_mm_storeu_si128((__m128i *)(out + i), _mm256_castsi256_si128(cells));
+		}
+		ToGridScalar(x + i, resolutions + i, out + i, n - i);
+	}
+
+	SOBOL_TARGET_AVX2 void ShiftToUnitAVX2(const uint32_t *x, const uint32_t *keys, double *out, unsigned int n) {
+		unsigned int i = 0;
+		for (; i + 8 <= n; i += 8) {
+			StoreUnitAVX2(_mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(x + i)), _mm256_loadu_si256((const __m256i *)(keys + i))), out + i);
+		}
+		ShiftToUnitScalar(x + i, keys + i, out + i, n - i);
+	}
+
+	SOBOL_TARGET_AVX2 void ShiftToUnitAVX2(const uint64_t *x, const uint64_t *keys, double *out, unsigned int n) {
+		unsigned int i = 0;
+		for (; i + 4 <= n; i += 4) {
+			StoreUnitAVX2(_mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(x + i)), _mm256_loadu_si256((const __m256i *)(keys + i))), out + i, 0);
+		}
+		ShiftToUnitScalar(x + i, keys + i, out + i, n - i);
+	}
+
+	// Reverses the nibbles through a 16 entry table and then the bytes of each lane, both with byte shuffles.
+	SOBOL_TARGET_AVX2 inline __m256i ReverseBitsAVX2(__m256i x) {
+		const __m256i nibbles = _mm256_setr_epi8(0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF,
+			0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF);
+		const __m256i bytes = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+			3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+		const __m256i lowNibbles = _mm256_set1_epi8(0x0F);
+		__m256i low = _mm256_shuffle_epi8(nibbles, _mm256_and_si256(x, lowNibbles));
+		__m256i high = _mm256_shuffle_epi8(nibbles, _mm256_and_si256(_mm256_srli_epi16(x, 4), lowNibbles));
+		return _mm256_shuffle_epi8(_mm256_or_si256(_mm256_slli_epi16(low, 4), high), bytes);
+	}
+
+	SOBOL_TARGET_AVX2 void OwenToUnitAVX2(const uint32_t *x, const uint32_t *keys, double *out, unsigned int n) {
+		const __m256i one = _mm256_set1_epi32(1);
+		unsigned int i = 0;
+		for (; i + 8 <= n; i += 8) {
+			__m256i seed = _mm256_loadu_si256((const __m256i *)(keys + i));
+			__m256i value = ReverseBitsAVX2(_mm256_loadu_si256((const __m256i *)(x + i)));
+			value = _mm256_xor_si256(value, _mm256_mullo_epi32(value, _mm256_set1_epi32(0x3d20adea)));
+			value = _mm256_add_epi32(value, seed);
+			value = _mm256_mullo_epi32(value, _mm256_or_si256(_mm256_srli_epi32(seed, 16), one));
+			value = _mm256_xor_si256(value, _mm256_mullo_epi32(value, _mm256_set1_epi32(0x05526c56)));
+			value = _mm256_xor_si256(value, _mm256_mullo_epi32(value, _mm256_set1_epi32(0x53a22864)));
+			StoreUnitAVX2(ReverseBitsAVX2(value), out + i);
+		}
+		OwenToUnitScalar(x + i, keys + i, out + i, n - i);
+	}
+
+	bool HasSSE2() {
+#if defined(_M_X64) || defined(__x86_64__)
+		return true;
+#elif defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 1);
+		return 0 != (info[3] & (1 << 26));
+#else
+		return __builtin_cpu_supports("sse2");
+#endif
+	}
+
+	bool HasAVX2() {
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7) {
+			return false;
+		}
+		__cpuid(info, 1);
+		const int osxsaveAndAVX = (1 << 27) | (1 << 28);
+		if ((info[2] & osxsaveAndAVX) != osxsaveAndAVX) {
+			return false;
+		}
+		if ((_xgetbv(0) & 6) != 6) {
+			// The OS does not preserve the YMM registers.
+			return false;
+		}
+		__cpuidex(info, 7, 0);
+		return 0 != (info[1] & (1 << 5));
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+#endif
+
+	template <typename Word>
+	struct WordDispatch {
+		void (*xorFunction)(Word *, const Word *, unsigned int);
+		void (*toUnitFunction)(const Word *, double *, unsigned int);
+		void (*xorToUnitFunction)(Word *, const Word *, double *, unsigned int);
+		void (*toFloatFunction)(const Word *, float *, unsigned int);
+		void (*toGridFunction)(const Word *, const uint32_t *, uint16_t *, unsigned int);
+		void (*shiftToUnitFunction)(const Word *, const Word *, double *, unsigned int);
+		void (*owenToUnitFunction)(const Word *, const Word *, double *, unsigned int);
+	};
+
+	struct Dispatch {
+		WordDispatch<uint32_t> word32;
+		WordDispatch<uint64_t> word64;
+		const char *name;
+
+		template <typename Word>
+		static void Select(WordDispatch<Word>& dispatch, void (*xorFunction)(Word *, const Word *, unsigned int),
+			void (*toUnitFunction)(const Word *, double *, unsigned int), void (*xorToUnitFunction)(Word *, const Word *, double *, unsigned int),
+			void (*shiftToUnitFunction)(const Word *, const Word *, double *, unsigned int), void (*owenToUnitFunction)(const Word *, const Word *, double *, unsigned int)) {
+			dispatch.xorFunction = xorFunction;
+			dispatch.toUnitFunction = toUnitFunction;
+			dispatch.xorToUnitFunction = xorToUnitFunction;
+			dispatch.shiftToUnitFunction = shiftToUnitFunction;
+			dispatch.owenToUnitFunction = owenToUnitFunction;
+		}
+
+		// The float and grid outputs only have vector versions for uint32_t words.
+		template <typename Word>
+		static void SelectNarrow(WordDispatch<Word>& dispatch, void (*toFloatFunction)(const Word *, float *, unsigned int),
+			void (*toGridFunction)(const Word *, const uint32_t *, uint16_t *, unsigned int)) {
+			dispatch.toFloatFunction = toFloatFunction;
+			dispatch.toGridFunction = toGridFunction;
+		}
+
+		Dispatch() {
+			Select<uint32_t>(word32, XorScalar, ToUnitScalar, XorToUnitScalar, ShiftToUnitScalar, OwenToUnitScalar);
+			Select<uint64_t>(word64, XorScalar, ToUnitScalar, XorToUnitScalar, ShiftToUnitScalar, OwenToUnitScalar);
+			SelectNarrow<uint32_t>(word32, ToFloatScalar, ToGridScalar);
+			SelectNarrow<uint64_t>(word64, ToFloatScalar, ToGridScalar);
+			name = "scalar";
+#ifdef SOBOL_KERNELS_X86
+			if (HasAVX2()) {
+				Select<uint32_t>(word32, XorAVX2, ToUnitAVX2, XorToUnitAVX2, ShiftToUnitAVX2, OwenToUnitAVX2);
+				Select<uint64_t>(word64, XorAVX2, ToUnitAVX2, XorToUnitAVX2, ShiftToUnitAVX2, OwenToUnitScalar);
+				SelectNarrow<uint32_t>(word32, ToFloatAVX2, ToGridAVX2);
+				name = "avx2";
+			}
+			else if (HasSSE2()) {
+				Select<uint32_t>(word32, XorSSE2, ToUnitSSE2, XorToUnitSSE2, ShiftToUnitSSE2, OwenToUnitSSE2);
+				Select<uint64_t>(word64, XorSSE2, ToUnitSSE2, XorToUnitSSE2, ShiftToUnitSSE2, OwenToUnitScalar);
+				SelectNarrow<uint32_t>(word32, ToFloatSSE2, ToGridScalar);
+				name = "sse2";
+			}
+#endif
+		}
+	};
+
+	const Dispatch& GetDispatch() {
+		static const Dispatch dispatch;
+		return dispatch;
+	}
+}
+
+void SobolKernels::Xor(uint32_t *x, const uint32_t *v, unsigned int n) {
+	GetDispatch().word32.xorFunction(x, v, n);
+}
+
+void SobolKernels::Xor(uint64_t *x, const uint64_t *v, unsigned int n) {
+	GetDispatch().word64.xorFunction(x, v, n);
+}
+
+void SobolKernels::ToUnit(const uint32_t *x, double *out, unsigned int n) {
+	GetDispatch().word32.toUnitFunction(x, out, n);
+}
+
+void SobolKernels::ToUnit(const uint64_t *x, double *out, unsigned int n) {
+	GetDispatch().word64.toUnitFunction(x, out, n);
+}
+
+void SobolKernels::XorToUnit(uint32_t *x, const uint32_t *v, double *out, unsigned int n) {
+	GetDispatch().word32.xorToUnitFunction(x, v, out, n);
+}
+
+void SobolKernels::XorToUnit(uint64_t *x, const uint64_t *v, double *out, unsigned int n) {
+	GetDispatch().word64.xorToUnitFunction(x, v, out, n);
+}
+
+void SobolKernels::ToFloat(const uint32_t *x, float *out, unsigned int n) {
+	GetDispatch().word32.toFloatFunction(x, out, n);
+}
+
+void SobolKernels::ToFloat(const uint64_t *x, float *out, unsigned int n) {
+	GetDispatch().word64.toFloatFunction(x, out, n);
+}
+
+void SobolKernels::ToGrid(const uint32_t *x, const uint32_t *resolutions, uint16_t *out, unsigned int n) {
+	GetDispatch().word32.toGridFunction(x, resolutions, out, n);
+}
+
+void SobolKernels::ToGrid(const uint64_t *x, const uint32_t *resolutions, uint16_t *out, unsigned int n) {
+	GetDispatch().word64.toGridFunction(x, resolutions, out, n);
+}
+
+void SobolKernels::ShiftToUnit(const uint32_t *x, const uint32_t *keys, double *out, unsigned int n) {
+	GetDispatch().word32.shiftToUnitFunction(x, keys, out, n);
+}
+
+void SobolKernels::ShiftToUnit(const uint64_t *x, const uint64_t *keys, double *out, unsigned int n) {
+	GetDispatch().word64.shiftToUnitFunction(x, keys, out, n);
+}
+
+void SobolKernels::OwenToUnit(const uint32_t *x, const uint32_t *keys, double *out, unsigned int n) {
+	GetDispatch().word32.owenToUnitFunction(x, keys, out, n);
+}
+
+void SobolKernels::OwenToUnit(const uint64_t *x, const uint64_t *keys, double *out, unsigned int n) {
+	GetDispatch().word64.owenToUnitFunction(x, keys, out, n);
+}
+
+const char *SobolKernels::Name() {
+	return GetDispatch().name;
+}
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "pch.h"
+
+#include <thread>
+#include "SobolParallelGenerator.h"
+
+template <typename Word>
+BasicParallelSobolGenerator<Word>::BasicParallelSobolGenerator(Word maxGenerating, unsigned short dimensions, unsigned int threads, const DirectionSet& directionSet)
+	: prototype(maxGenerating, dimensions, directionSet) {
+	Start(threads);
+}
+
+template <typename Word>
+BasicParallelSobolGenerator<Word>::BasicParallelSobolGenerator(SobolUnbounded unbounded, unsigned short dimensions, unsigned int threads, const DirectionSet& directionSet)
+	: prototype(unbounded, dimensions, directionSet) {
+	Start(threads);
+}
+
+template <typename Word>
+BasicParallelSobolGenerator<Word>::~BasicParallelSobolGenerator() {
+	{
+		lock_guard<mutex> guard(lock);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (auto it = pool.begin(); it != pool.end(); ++it) {
+		it->join();
+	}
+}
+
+template <typename Word>
+void BasicParallelSobolGenerator<Word>::Start(unsigned int threads) {
+	if (0 == threads) {
+		threads = thread::hardware_concurrency();
+	}
+	this->threads = 0 == threads ? 1 : threads;
+	work = nullptr;
+	workers = 0;
+	running = 0;
+	round = 0;
+	stopping = false;
+	for (unsigned int worker = 1; worker < this->threads; ++worker) {
+		pool.push_back(thread(&BasicParallelSobolGenerator::WorkerLoop, this, worker));
+	}
+}
+
+template <typename Word>
+void BasicParallelSobolGenerator<Word>::WorkerLoop(unsigned int worker) {
+	uint64_t seen = 0;
+	unique_lock<mutex> guard(lock);
+	while (true) {
+		wake.wait(guard, [&]() { return stopping || seen != round; });
+		if (stopping) {
+			return;
+		}
+		seen = round;
+		if (worker >= workers) {
+			continue;
+		}
+
+		const function<void(unsigned int)> *current = work;
+		guard.unlock();
+		(*current)(worker);
+		guard.lock();
+		if (0 == --running) {
+			done.notify_one();
+		}
+	}
+}
+
+template <typename Word>
+void BasicParallelSobolGenerator<Word>::RunWorkers(unsigned int workers, const function<void(unsigned int)>& work) {
+	if (workers <= 1) {
+		if (1 == workers) {
+			work(0);
+		}
+		return;
+	}
+
+	lock_guard<mutex> call(calling);
+	{
+		lock_guard<mutex> guard(lock);
+		this->work = &work;
+		this->workers = workers;
+		running = workers - 1;
+		++round;
+	}
+	wake.notify_all();
+	work(0);
+	unique_lock<mutex> guard(lock);
+	done.wait(guard, [&]() { return 0 == running; });
+}
+
+template <typename Word>
+Word BasicParallelSobolGenerator<Word>::Generate(double *points, Word begin, Word count, SobolLayout layout) {
+	const Word maxGenerating = prototype.GetMaxGenerating();
+	const unsigned short dimensions = prototype.GetDimensions();
+	const size_t dimensionStride = (size_t)count;
+	if (begin >= maxGenerating) {
+		return 0;
+	}
+	if (maxGenerating - begin < count) {
+		count = maxGenerating - begin;
+	}
+
+	Word chunks = count / chunkSize + (0 != count % chunkSize ? 1 : 0);
+	unsigned int workers = chunks < threads ? (unsigned int)chunks : threads;
+	auto generateSlice = [&](unsigned int worker) {
+		// Worker w takes chunks [w * chunks / workers, (w + 1) * chunks / workers), spelled out to avoid overflow.
+		// Only the last chunk is partial and rounding count up to whole chunks can overflow Word, so the end of
+		// the range is count itself rather than chunks * chunkSize.
+		Word chunkBegin = chunks / workers * worker + (worker < chunks % workers ? worker : chunks % workers);
+		Word chunkEnd = chunkBegin + chunks / workers + (worker < chunks % workers ? 1 : 0);
+		Word sliceBegin = chunkBegin * chunkSize;
+		Word sliceEnd = chunkEnd < chunks ? chunkEnd * chunkSize : count;
+
+		BasicSobolGenerator<Word> generator(prototype);
+		generator.Seek(begin + sliceBegin);
+		if (SobolLayout::PointMajor == layout) {
+			generator.GetBlock(points + (size_t)sliceBegin * dimensions, sliceEnd - sliceBegin, layout);
+		}
+		else {
+			generator.GetBlock(points + (size_t)sliceBegin, sliceEnd - sliceBegin, layout, dimensionStride);
+		}
+	};
+
+	RunWorkers(workers, generateSlice);
+	return count;
+}
+
+template <typename Word>
+Word BasicParallelSobolGenerator<Word>::Generate(double *points, SobolLayout layout) {
+	return Generate(points, 0, prototype.GetMaxGenerating(), layout);
+}
+
+template <typename Word>
+Word BasicParallelSobolGenerator<Word>::GenerateByDimension(double *points, Word begin, Word count) {
+	const unsigned short dimensions = prototype.GetDimensions();
+	const size_t dimensionStride = (size_t)count;
+	if (begin >= prototype.GetMaxGenerating()) {
+		return 0;
+	}
+	if (prototype.GetMaxGenerating() - begin < count) {
+		count = prototype.GetMaxGenerating() - begin;
+	}
+	// GetDimension is const and leaves growing the direction numbers of an unbounded generator to us.
+	prototype.Reserve(begin + count);
+
+	unsigned int workers = dimensions < threads ? dimensions : threads;
+	auto generateColumns = [&](unsigned int worker) {
+		unsigned short dimensionBegin = (unsigned short)((unsigned int)dimensions * worker / workers);
+		unsigned short dimensionEnd = (unsigned short)((unsigned int)dimensions * (worker + 1) / workers);
+		for (unsigned short j = dimensionBegin; j < dimensionEnd; ++j) {
+			prototype.GetDimension(j, begin, count, points + j * dimensionStride);
+		}
+	};
+
+	RunWorkers(workers, generateColumns);
+	return count;
+}
+
+template class BasicParallelSobolGenerator<uint32_t>;
+template class BasicParallelSobolGenerator<uint64_t>;
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#ifndef SOBOL_PARALLEL_GENERATOR_H
+#define SOBOL_PARALLEL_GENERATOR_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "SobolGenerator.h"
+
+// Generates index ranges of a Sobol sequence on several threads. Every worker copies a prototype generator and
+// seeks it to the start of its own slice, so the output is bit-identical to a serial generator whatever the
+// number of threads.
+// The worker threads are started with the generator and wait between calls, so a call only wakes them rather than
+// creating threads. The calling thread works as the first worker, and calls from several threads that need the
+// pool take turns.
+template <typename Word>
+class BasicParallelSobolGenerator {
+public:
+	// threads = 0 uses one thread per hardware thread.
+	BasicParallelSobolGenerator(Word maxGenerating, unsigned short dimensions, unsigned int threads = 0, const DirectionSet& directionSet = globalNewJoeKuo621201);
+	// Over an open-ended sequence, see BasicSobolGenerator. Only the ranges of Generate and GenerateByDimension
+	// make sense then, the whole sequence would not fit in memory.
+	BasicParallelSobolGenerator(SobolUnbounded unbounded, unsigned short dimensions, unsigned int threads = 0, const DirectionSet& directionSet = globalNewJoeKuo621201);
+	~BasicParallelSobolGenerator();
+	BasicParallelSobolGenerator(const BasicParallelSobolGenerator&) = delete;
+	BasicParallelSobolGenerator& operator=(const BasicParallelSobolGenerator&) = delete;
+
+	// Generates the points of [begin, begin + count) into points, which must hold count * dimensions values laid
+	// out as BasicSobolGenerator::GetBlock does for a block of count points. Returns the number of points generated.
+	Word Generate(double *points, Word begin, Word count, SobolLayout layout = SobolLayout::PointMajor);
+	// Generates the whole sequence, points must hold maxGenerating * dimensions values.
+	Word Generate(double *points, SobolLayout layout = SobolLayout::PointMajor);
+	// Same output as Generate with SobolLayout::DimensionMajor, but the threads split the dimensions instead of the
+	// index range: each worker fills whole columns with BasicSobolGenerator::GetDimension. Scales better when there
+	// are many more dimensions than points to share out.
+	Word GenerateByDimension(double *points, Word begin, Word count);
+
+	unsigned int GetThreads() const { return threads; }
+	// Same as BasicSobolGenerator::Scramble, for every worker.
+	void Scramble(SobolScrambling scrambling, uint64_t seed = 0) { prototype.Scramble(scrambling, seed); }
+
+private:
+	// Sets the thread count and starts the threads - 1 pool workers.
+	void Start(unsigned int threads);
+	void WorkerLoop(unsigned int worker);
+	// Runs work(0) to work(workers - 1), work(0) on the calling thread, and returns once all are done. A single
+	// worker runs on the calling thread alone without touching the pool.
+	void RunWorkers(unsigned int workers, const function<void(unsigned int)>& work);
+
+	// Slices handed to the workers are multiples of this, so that they never share a cache line of output.
+	static const unsigned int chunkSize = 1 << 12;
+
+	BasicSobolGenerator<Word> prototype;
+	unsigned int threads;
+
+	vector<thread> pool;
+	// Held by a call from start to end, so that calls do not mix their work.
+	mutex calling;
+	// Guards the fields below, which hand the work of a call to the pool.
+	mutex lock;
+	condition_variable wake, done;
+	const function<void(unsigned int)> *work;
+	// Workers taking part in the current call, and those of the pool still running it.
+	unsigned int workers, running;
+	// Counts the calls, a worker runs each call once.
+	uint64_t round;
+	bool stopping;
+};
+
+typedef BasicParallelSobolGenerator<uint32_t> ParallelSobolGenerator;
+typedef BasicParallelSobolGenerator<uint64_t> ParallelSobolGenerator64;
+
+#endif //SOBOL_PARALLEL_GENERATOR_H
\ No newline at end of file
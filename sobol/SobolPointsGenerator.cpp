@@ -3,55 +3,6 @@
 
 #include "pch.h"
 
-// Frances Y. Kuo
-//
-// Email: <f.kuo@unsw.edu.au>
-// School of Mathematics and Statistics
-// University of New South Wales
-// Sydney NSW 2052, Australia
-// 
-// Last updated: 21 October 2008
-//
-//   You may incorporate this source code into your own program 
-//   provided that you
-//   1) acknowledge the copyright owner in your program and publication
-//   2) notify the copyright owner by email
-//   3) offer feedback regarding your experience with different direction numbers
-//
-//
-// -----------------------------------------------------------------------------
-// Licence pertaining to sobol.cc and the accompanying sets of direction numbers
-// -----------------------------------------------------------------------------
-// Copyright (c) 2008, Frances Y. Kuo and Stephen Joe
-// All rights reserved.
-// 
-// Redistribution and use in source and binary forms, with or without
-// modification, are permitted provided that the following conditions are met:
-// 
-//     * Redistributions of source code must retain the above copyright
-//       notice, this list of conditions and the following disclaimer.
-// 
-//     * Redistributions in binary form must reproduce the above copyright
-//       notice, this list of conditions and the following disclaimer in the
-//       documentation and/or other materials provided with the distribution.
-// 
-//     * Neither the names of the copyright holders nor the names of the
-//       University of New South Wales and the University of Waikato
-//       and its contributors may be used to endorse or promote products derived
-//       from this software without specific prior written permission.
-// 
-// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
-// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
-// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
-// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
-// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
-// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
-// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
-// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
-// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
-// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-// -----------------------------------------------------------------------------
-
 #include <cstdlib> // *** Thanks to Leonhard Gruenschloss and Mike Giles   ***
 #include <cmath>   // *** for pointing out the change in new g++ compilers ***
 
@@ -61,146 +12,327 @@
 #include <string>
 
 #include <vector>
+#include <algorithm>
+#include <chrono>
 
 #include "SobolGenerator.h"
+#include "SobolReference.h"
+#include "SobolBenchmark.h"
+#include "SobolVerifier.h"
+#include "Discrepancy.h"
+#include "SobolDirectionFile.h"
+#include "MappedFile.h"
 
 using namespace std;
 
-// ----- SOBOL POINTS GENERATOR BASED ON GRAYCODE ORDER -----------------
-// INPUT: 
-//   N         number of points  (cannot be greater than 2^32)
-//   D         dimension  (make sure that the data file contains enough data!!)      
-//   dir_file  the input file containing direction numbers
-//
-// OUTPUT:
-//   A 2-dimensional array POINTS, where
-//     
-//     POINTS[i][j] = the jth component of the ith point,
-//   
-//   with i indexed from 0 to N-1 and j indexed from 0 to D-1
-//
-// ----------------------------------------------------------------------
+// Writes count points as raw Output values, point-major in the byte order of the machine, to path. The generator
+// fills blocks of about 4 MB at a time, either straight into a mapping of the output file or into one buffer that is
+// written out, so the memory used does not grow with count.
+template <typename Output>
+bool StreamPoints(uint32_t count, unsigned short dimensions, const char *path, bool mapped) {
+	SobolGenerator sobolGenerator(count, dimensions);
+	const size_t pointBytes = sizeof(Output) * dimensions;
+	const uint32_t blockPoints = (uint32_t)max<size_t>(1, ((size_t)4 << 20) / pointBytes);
 
-const double dividend = pow(2.0, 32);
+	if (mapped) {
+		const uint64_t bytes = (uint64_t)count * pointBytes;
+		MappedFile outfile;
+		if ((size_t)bytes != bytes || !outfile.Create(path, (size_t)bytes)) {
+			return false;
+		}
+		Output *points = (Output *)outfile.GetWritableData();
+		for (uint32_t generated = 0; generated < count; ) {
+			generated += sobolGenerator.GetBlock(points + (size_t)generated * dimensions, min(blockPoints, count - generated));
+		}
+		return true;
+	}
 
-double **sobol_points(unsigned N, unsigned D, const char *dir_file)
-{
-	ifstream infile(dir_file, ios::in);
-	if (!infile) {
-		cout << "Input file containing direction numbers cannot be found!\n";
-		exit(1);
+	ofstream outfile(path, ios::out | ios::binary | ios::trunc);
+	vector<Output> block((size_t)blockPoints * dimensions);
+	while (uint32_t generated = sobolGenerator.GetBlock(block.data(), blockPoints)) {
+		outfile.write((const char *)block.data(), (streamsize)(generated * pointBytes));
 	}
-	char buffer[1000];
-	infile.getline(buffer, 1000, '\n');
-
-	// L = max number of bits needed 
-	unsigned L = (unsigned)ceil(log((double)N) / log(2.0));
-
-	// C[i] = index from the right of the first zero bit of i
-	unsigned *C = new unsigned[N];
-	C[0] = 1;
-	for (unsigned i = 1; i <= N - 1; i++) {
-		C[i] = 1;
-		unsigned value = i;
-		while (value & 1) {
-			value >>= 1;
-			C[i]++;
+	outfile.close();
+	return !outfile.fail();
+}
+
+// Parses a comma separated list of unsigned numbers, such as 10,20,30, into values.
+template <typename Value>
+bool ParseList(const string& text, vector<Value>& values) {
+	values.clear();
+	for (size_t begin = 0; begin <= text.size(); ) {
+		size_t end = text.find(',', begin);
+		end = string::npos == end ? text.size() : end;
+		char *parsed;
+		const unsigned long long value = strtoull(text.c_str() + begin, &parsed, 10);
+		if (parsed != text.c_str() + end || begin == end || (Value)value != value) {
+			return false;
 		}
+		values.push_back((Value)value);
+		begin = end + 1;
 	}
+	return true;
+}
 
-	// POINTS[i][j] = the jth component of the ith point
-	//                with i indexed from 0 to N-1 and j indexed from 0 to D-1
-	double **POINTS = new double *[N];
-	for (unsigned i = 0; i <= N - 1; i++) POINTS[i] = new double[D];
-	for (unsigned j = 0; j <= D - 1; j++) POINTS[0][j] = 0;
-
-	// ----- Compute the first dimension -----
-
-	// Compute direction numbers V[1] to V[L], scaled by pow(2,32)
-	unsigned *V = new unsigned[L + 1];
-	for (unsigned i = 1; i <= L; i++) V[i] = 1 << (32 - i); // all m's = 1
-
-	// Evalulate X[0] to X[N-1], scaled by pow(2,32)
-	unsigned *X = new unsigned[N];
-	X[0] = 0;
-	for (unsigned i = 1; i <= N - 1; i++) {
-		X[i] = X[i - 1] ^ V[C[i - 1]];
-		POINTS[i][0] = (double)X[i] / dividend; // *** the actual points
-		//        ^ 0 for first dimension
-	}
+int main(int argc, char **argv) {
+	if (3 <= argc && string("bench") == argv[1]) {
+		// SobolPointsGenerator bench results.json [modes=block,parallel] [log2counts=10,20,30] [dimensions=2,3]
+		//   [batches=256,65536] [seconds=0.1,1] [threads=8] [reference=new-joe-kuo-6.21201]
+		SobolBenchmarkOptions options;
+		for (int i = 3; i < argc; ++i) {
+			const string argument = argv[i];
+			const size_t equals = argument.find('=');
+			const string name = argument.substr(0, equals), value = string::npos == equals ? string() : argument.substr(equals + 1);
+			vector<double> seconds;
+			vector<unsigned int> threads;
+			bool parsed = string::npos != equals;
+			if ("modes" == name) {
+				options.modes.clear();
+				for (size_t begin = 0; begin <= value.size(); ) {
+					const size_t end = min(value.find(',', begin), value.size());
+					options.modes.push_back(value.substr(begin, end - begin));
+					begin = end + 1;
+				}
+			}
+			else if ("log2counts" == name) {
+				parsed = parsed && ParseList(value, options.log2Counts);
+			}
+			else if ("dimensions" == name) {
+				parsed = parsed && ParseList(value, options.dimensions);
+			}
+			else if ("batches" == name) {
+				parsed = parsed && ParseList(value, options.batchSizes);
+			}
+			else if ("seconds" == name) {
+				char *end;
+				options.minSeconds = strtod(value.c_str(), &end);
+				options.maxSeconds = ',' == *end ? strtod(end + 1, &end) : options.minSeconds;
+				parsed = parsed && '\0' == *end && 0.0 <= options.minSeconds && options.minSeconds <= options.maxSeconds;
+			}
+			else if ("threads" == name) {
+				parsed = parsed && ParseList(value, threads) && 1 == threads.size();
+				options.threads = parsed ? threads[0] : 0;
+			}
+			else if ("reference" == name) {
+				options.referenceFile = value;
+			}
+			else {
+				parsed = false;
+			}
+			if (!parsed) {
+				cout << "Usage: SobolPointsGenerator bench <output.json> [modes=next,block,float,uint32,shift,owen,block64,parallel,dimension,reference] [log2counts=10,14,...,30]"
+					<< " [dimensions=2,3,...] [batches=256,4096,...] [seconds=<min>,<max>] [threads=<count>] [reference=<direction file>]" << endl;
+				return 1;
+			}
+		}
 
-	// Clean up
-	delete[] V;
-	delete[] X;
+		const vector<SobolBenchmarkResult> results = RunSobolBenchmark(options, &cout);
+		ofstream outfile(argv[2]);
+		WriteSobolBenchmarkJson(outfile, options, results);
+		outfile.close();
+		if (outfile.fail()) {
+			cout << "Results cannot be written to " << argv[2] << endl;
+			return 1;
+		}
+		cout << "Benchmark Finished" << endl;
+		return 0;
+	}
 
+	if (5 <= argc && string("discrepancy") == argv[1]) {
+		// SobolPointsGenerator discrepancy sobol 1000000 2 [none|shift|owen] [seed]
+		// SobolPointsGenerator discrepancy file points.bin 2, with the raw doubles of stream
+		const string source = argv[2];
+		const unsigned long dimensions = strtoul(argv[4], nullptr, 10);
+		vector<double> generated;
+		MappedFile infile;
+		const double *points = nullptr;
+		size_t count = 0;
+		const auto start = chrono::steady_clock::now();
+		if (0 != dimensions && dimensions <= globalNewJoeKuo621201.dimensions) {
+			if ("sobol" == source && argc <= 7) {
+				const unsigned long long requested = strtoull(argv[3], nullptr, 10);
+				const string scrambling = 6 <= argc ? argv[5] : "none";
+				const uint64_t seed = 7 == argc ? strtoull(argv[6], nullptr, 10) : 0;
+				if (0 != requested && requested <= 0xFFFFFFFFull && ("none" == scrambling || "shift" == scrambling || "owen" == scrambling)) {
+					SobolGenerator sobolGenerator((uint32_t)requested, (unsigned short)dimensions);
+					if ("none" != scrambling) {
+						sobolGenerator.Scramble("shift" == scrambling ? SobolScrambling::DigitalShift : SobolScrambling::Owen, seed);
+					}
+					generated.resize((size_t)requested * dimensions);
+					count = sobolGenerator.GetBlock(generated.data(), (uint32_t)requested);
+					points = generated.data();
+				}
+			}
+			else if ("file" == source && 5 == argc) {
+				if (!infile.Open(argv[3])) {
+					cout << "Points cannot be read from " << argv[3] << endl;
+					return 1;
+				}
+				points = (const double *)infile.GetData();
+				count = infile.GetSize() / (sizeof(double) * dimensions);
+			}
+		}
+		if (nullptr == points) {
+			cout << "Usage: SobolPointsGenerator discrepancy sobol <count> <dimensions> [none|shift|owen] [seed]" << endl
+				<< "       SobolPointsGenerator discrepancy file <points of doubles> <dimensions>" << endl;
+			return 1;
+		}
 
-	// ----- Compute the remaining dimensions -----
-	for (unsigned j = 1; j <= D - 1; j++) {
+		const auto generatedAt = chrono::steady_clock::now();
+		const double star = L2StarDiscrepancy(points, count, (unsigned short)dimensions);
+		const auto starAt = chrono::steady_clock::now();
+		const double centered = CenteredL2Discrepancy(points, count, (unsigned short)dimensions);
+		const auto centeredAt = chrono::steady_clock::now();
+		cout << setprecision(9) << count << " points in " << dimensions << " dimensions, read or generated in "
+			<< chrono::duration<double, milli>(generatedAt - start).count() << " ms" << endl;
+		cout << "L2 star discrepancy " << star << " in " << chrono::duration<double, milli>(starAt - generatedAt).count() << " ms" << endl;
+		cout << "Centered L2 discrepancy " << centered << " in " << chrono::duration<double, milli>(centeredAt - starAt).count() << " ms" << endl;
+		return 0;
+	}
 
-		// Read in parameters from file 
-		unsigned d, s;
-		unsigned a;
-		infile >> d >> s >> a;
-		unsigned *m = new unsigned[s + 1];
-		for (unsigned i = 1; i <= s; i++) infile >> m[i];
+	if (6 <= argc && string("verify") == argv[1]) {
+		// SobolPointsGenerator verify 4294967295 2 reference block [chunk=65536] [threads=8] [reference=new-joe-kuo-6.21201]
+		//   [bits=64] [scrambling=owen] [seed=1]
+		const unsigned long long count = strtoull(argv[2], nullptr, 10);
+		const unsigned long dimensions = strtoul(argv[3], nullptr, 10);
+		SobolVerifyMode first, second;
+		SobolVerifyOptions options;
+		bool parsed = ParseSobolVerifyMode(argv[4], first) && ParseSobolVerifyMode(argv[5], second)
+			&& 0 != count && count <= 0xFFFFFFFFull && 0 != dimensions && dimensions <= globalNewJoeKuo621201.dimensions;
+		for (int i = 6; parsed && i < argc; ++i) {
+			const string argument = argv[i];
+			const size_t equals = argument.find('=');
+			const string name = argument.substr(0, equals), value = string::npos == equals ? string() : argument.substr(equals + 1);
+			vector<uint32_t> number;
+			if ("chunk" == name) {
+				parsed = ParseList(value, number) && 1 == number.size();
+				options.chunkSize = parsed ? number[0] : 0;
+			}
+			else if ("threads" == name) {
+				parsed = ParseList(value, number) && 1 == number.size();
+				options.threads = parsed ? number[0] : 0;
+			}
+			else if ("reference" == name) {
+				options.referenceFile = value;
+			}
+			else if ("bits" == name) {
+				parsed = ParseList(value, number) && 1 == number.size() && (32 == number[0] || 64 == number[0]);
+				options.bits = parsed ? number[0] : 32;
+			}
+			else if ("scrambling" == name) {
+				parsed = "none" == value || "shift" == value || "owen" == value;
+				options.scrambling = "shift" == value ? SobolScrambling::DigitalShift : "owen" == value ? SobolScrambling::Owen : SobolScrambling::None;
+			}
+			else if ("seed" == name) {
+				parsed = !value.empty();
+				options.seed = strtoull(value.c_str(), nullptr, 10);
+			}
+			else {
+				parsed = false;
+			}
+		}
+		if (!parsed) {
+			cout << "Usage: SobolPointsGenerator verify <count below 2^32> <dimensions up to " << globalNewJoeKuo621201.dimensions << "> <mode> <mode>"
+				<< " [chunk=<points>] [threads=<count>] [reference=<direction file>] [bits=32|64] [scrambling=none|shift|owen] [seed=<seed>]" << endl
+				<< "  modes: reference, serial, block, doubleblock, parallel, skipahead, pointat, leapfrog" << endl;
+			return 1;
+		}
 
-		// Compute direction numbers V[1] to V[L], scaled by pow(2,32)
-		unsigned *V = new unsigned[L + 1];
-		if (L <= s) {
-			for (unsigned i = 1; i <= L; i++) V[i] = m[i] << (32 - i);
+		const SobolVerifyResult result = VerifySobolModes(first, second, (uint32_t)count, (unsigned short)dimensions, options, &cout);
+		if (!result.opened) {
+			cout << "Input file containing direction numbers cannot be found!" << endl;
+			return 1;
 		}
-		else {
-			for (unsigned i = 1; i <= s; i++) V[i] = m[i] << (32 - i);
-			for (unsigned i = s + 1; i <= L; i++) {
-				V[i] = V[i - s] ^ (V[i - s] >> s);
-				for (unsigned k = 1; k <= s - 1; k++)
-					V[i] ^= (((a >> (s - 1 - k)) & 1) * V[i - k]);
-			}
+		if (!result.identical) {
+			cout << "Mismatch at point " << result.mismatchIndex << " dimension " << result.mismatchDimension << ": "
+				<< argv[4] << " " << result.firstWord << ", " << argv[5] << " " << result.secondWord << endl;
+			return 1;
 		}
+		cout << "Identical " << result.verified << " points, hash " << hex << setw(16) << setfill('0') << result.firstHash << endl;
+		return 0;
+	}
 
-		// Evalulate X[0] to X[N-1], scaled by pow(2,32)
-		unsigned *X = new unsigned[N];
-		X[0] = 0;
-		for (unsigned i = 1; i <= N - 1; i++) {
-			X[i] = X[i - 1] ^ V[C[i - 1]];
-			POINTS[i][j] = (double)X[i] / dividend; // *** the actual points
-			//        ^ j for dimension (j+1)
+	if ((6 == argc || 7 == argc) && string("stream") == argv[1]) {
+		// SobolPointsGenerator stream 1000000000 2 float points.bin [mmap]
+		const unsigned long long count = strtoull(argv[2], nullptr, 10);
+		const unsigned long dimensions = strtoul(argv[3], nullptr, 10);
+		const string format = argv[4];
+		const bool mapped = 7 == argc && string("mmap") == argv[6];
+		const unsigned short probe = 1;
+		if (1 != *(const unsigned char *)&probe) {
+			cout << "Raw points are little endian, this machine is not" << endl;
+			return 1;
+		}
+		if (0 == count || count > 0xFFFFFFFFull || 0 == dimensions || dimensions > globalNewJoeKuo621201.dimensions) {
+			cout << "Usage: SobolPointsGenerator stream <count below 2^32> <dimensions up to " << globalNewJoeKuo621201.dimensions << "> <double|float|uint32> <output> [mmap]" << endl;
+			return 1;
 		}
 
-		// Clean up
-		delete[] m;
-		delete[] V;
-		delete[] X;
+		bool written;
+		if ("double" == format) {
+			written = StreamPoints<double>((uint32_t)count, (unsigned short)dimensions, argv[5], mapped);
+		}
+		else if ("float" == format) {
+			written = StreamPoints<float>((uint32_t)count, (unsigned short)dimensions, argv[5], mapped);
+		}
+		else if ("uint32" == format) {
+			written = StreamPoints<uint32_t>((uint32_t)count, (unsigned short)dimensions, argv[5], mapped);
+		}
+		else {
+			cout << "Unknown point format " << format << ", expected double, float or uint32" << endl;
+			return 1;
+		}
+		if (!written) {
+			cout << "Points cannot be written to " << argv[5] << endl;
+			return 1;
+		}
+		cout << "Generation Finished" << endl;
+		return 0;
 	}
-	delete[] C;
-
-	return POINTS;
-}
 
+	if (4 == argc && string("convert") == argv[1]) {
+		// SobolPointsGenerator convert new-joe-kuo-6.21201 new-joe-kuo-6.21201.sobol
+		if (!ConvertJoeKuoDirections(argv[2], argv[3])) {
+			cout << "Direction numbers cannot be converted from " << argv[2] << " to " << argv[3] << endl;
+			return 1;
+		}
+		cout << "Conversion Finished" << endl;
+		return 0;
+	}
 
-int main() {
 	ofstream outfile("output.txt");
 	int generateNPoints, dimensions;
 	cin >> generateNPoints >> dimensions;
 
 	outfile << setprecision(20);
 
-	double **P = sobol_points(generateNPoints, dimensions, "new-joe-kuo-6.21201");
+	SobolReference reference;
+	if (!reference.Open("new-joe-kuo-6.21201", dimensions)) {
+		cout << "Input file containing direction numbers cannot be found!" << endl;
+		return 1;
+	}
 	//cout << setiosflags(ios::scientific) << setprecision(10);
 
+	// The reference runs ahead a chunk at a time, so the memory used does not depend on the number of points.
+	const int chunkSize = 4096;
+	vector<double> expected((size_t)chunkSize * dimensions);
 	vector<double> point;
 	auto sobolGenerator = new SobolGenerator(generateNPoints, dimensions);
 	for (int i = 0; i <= generateNPoints && sobolGenerator->GetNext(point); ++i, point.clear()) {
+		if (0 == i % chunkSize) {
+			reference.Generate(expected.data(), min(chunkSize, generateNPoints - i));
+		}
+		const double *P = expected.data() + (size_t)(i % chunkSize) * dimensions;
 		outfile << "[" << i << "] ";
 		for (int j = 0; j < dimensions; ++j) {
-			if (P[i][j] != point[j]) {
+			if (P[j] != point[j]) {
 				cout << "Incorrect generated data for point " << i << " dimension " << j << endl;
 				cin >> generateNPoints;
 				return 1;
 			}
 			outfile << point[j] << " ";
 		}
-		outfile << endl;
+		outfile << "\n";
 	}
 
 	outfile.close();
@@ -209,6 +341,7 @@ int main() {
 	return 0;
 }
 //
+//// Emits the tables of SobolDirection.cpp from the direction number file.
 //int main() {
 //	ifstream infile("new-joe-kuo-6.21201", ios::in);
 //	if (!infile) {
@@ -218,25 +351,31 @@ int main() {
 //	char buffer[1000];
 //	infile.getline(buffer, 1000, '\n');
 //
-//	int d, s, a, m;
+//	unsigned d, s, a, m;
+//	vector<vector<unsigned>> initialDirections;
+//	unsigned offset = 0;
 //	ofstream outfile("gen_code.txt");
 //
-//	int i = 0;
-//	while (!infile.eof()) {
-//		infile >> d >> s >> a;
-//		outfile << "Direction::Init(directions[" << i << "], " << d << ", " << a << ", " << s << ", ";
-//		for (int i = 0; i < s; ++i) {
+//	outfile << "\tconstexpr PackedDirection directions[21200] = {";
+//	while (infile >> d >> s >> a) {
+//		outfile << (0 == offset ? "" : ",") << "\n\t\tPackDirection(" << s << ", " << a << ", " << offset << ")";
+//		offset += s;
+//		initialDirections.push_back(vector<unsigned>());
+//		for (unsigned i = 0; i < s; ++i) {
 //			infile >> m;
-//			outfile << m;
-//			if (s-1 == i) {
-//				outfile << ");" << endl;
-//			}
-//			else {
-//				outfile << ", ";
-//			}
+//			initialDirections.back().push_back(m);
+//		}
+//	}
+//	outfile << "\n\t};" << endl << endl;
+//
+//	outfile << "\tconstexpr unsigned int initialDirections[" << offset << "] = {";
+//	for (size_t i = 0; i < initialDirections.size(); ++i) {
+//		outfile << "\n\t\t";
+//		for (size_t j = 0; j < initialDirections[i].size(); ++j) {
+//			outfile << initialDirections[i][j] << (initialDirections.size() - 1 == i && initialDirections[i].size() - 1 == j ? "" : (initialDirections[i].size() - 1 == j ? "," : ", "));
 //		}
-//		i++;
 //	}
+//	outfile << "\n\t};" << endl;
 //
 //	outfile.close();
 //}
\ No newline at end of file
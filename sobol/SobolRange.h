@@ -0,0 +1,110 @@
+#pragma once
+
+#ifndef SOBOL_RANGE_H
+#define SOBOL_RANGE_H
+
+#include <cstddef>
+#include <iterator>
+#include "FixedSobolGenerator.h"
+
+// Random access view over the points [begin, end) of the sequence of a FixedSobolGenerator. Every point is computed
+// straight from its index with PointAt and returned by value as a fixed-size array, so reading a point never
+// allocates nor touches the generator state, and iterators are independent of each other.
+// The iterators are random access counting iterators over the indices, which the standard algorithms, the parallel
+// ones included, can share out and jump through in O(1):
+//   SobolRange<2> sites(generator);
+//   for_each(execution::par, sites.begin(), sites.end(), [](const SobolRange<2>::Point& p) { ... });
+// Like the proxies of vector<bool>, reference is the Point itself returned by value rather than a reference into
+// storage, so two iterators at the same index yield equal points but not the same object.
+// The generator must outlive the range and its iterators, and must not be modified while they are in use.
+template <unsigned short D, typename Word = uint32_t>
+class SobolRange {
+public:
+	typedef FixedSobolGenerator<D, Word> Generator;
+	typedef typename Generator::Point Point;
+
+	class Iterator {
+	public:
+		// Holds the point operator-> computed, for it to point to.
+		class Arrow {
+		public:
+			explicit Arrow(const Point& point) : point(point) {}
+			const Point *operator->() const { return &point; }
+
+		private:
+			Point point;
+		};
+
+		typedef random_access_iterator_tag iterator_category;
+#if __cplusplus >= 202002L
+		typedef random_access_iterator_tag iterator_concept;
+#endif
+		typedef Point value_type;
+		typedef ptrdiff_t difference_type;
+		typedef Arrow pointer;
+		// Proxy reference: points are computed on dereference, so they are returned by value.
+		typedef Point reference;
+
+		Iterator() : generator(nullptr), index(0) {}
+		Iterator(const Generator *generator, Word index) : generator(generator), index(index) {}
+
+		Word GetIndex() const { return index; }
+
+		Point operator*() const {
+			Point point = {};
+			generator->PointAt(index, point);
+			return point;
+		}
+		Arrow operator->() const { return Arrow(**this); }
+		Point operator[](difference_type offset) const { return *(*this + offset); }
+
+		Iterator& operator++() { ++index; return *this; }
+		Iterator operator++(int) { Iterator previous = *this; ++index; return previous; }
+		Iterator& operator--() { --index; return *this; }
+		Iterator operator--(int) { Iterator previous = *this; --index; return previous; }
+		Iterator& operator+=(difference_type offset) { index = (Word)(index + offset); return *this; }
+		Iterator& operator-=(difference_type offset) { index = (Word)(index - offset); return *this; }
+		Iterator operator+(difference_type offset) const { return Iterator(generator, (Word)(index + offset)); }
+		Iterator operator-(difference_type offset) const { return Iterator(generator, (Word)(index - offset)); }
+		friend Iterator operator+(difference_type offset, const Iterator& it) { return it + offset; }
+		difference_type operator-(const Iterator& other) const { return (difference_type)index - (difference_type)other.index; }
+
+		bool operator==(const Iterator& other) const { return index == other.index; }
+		bool operator!=(const Iterator& other) const { return index != other.index; }
+		bool operator<(const Iterator& other) const { return index < other.index; }
+		bool operator>(const Iterator& other) const { return index > other.index; }
+		bool operator<=(const Iterator& other) const { return index <= other.index; }
+		bool operator>=(const Iterator& other) const { return index >= other.index; }
+
+	private:
+		const Generator *generator;
+		Word index;
+	};
+
+	typedef Iterator iterator;
+	typedef Iterator const_iterator;
+
+	// The whole sequence of generator.
+	explicit SobolRange(const Generator& generator) : generator(&generator), first(0), last(generator.GetMaxGenerating()) {}
+	// The points [begin, end) of the sequence of generator, end is clamped to its length.
+	SobolRange(const Generator& generator, Word begin, Word end) : generator(&generator), first(begin), last(end) {
+		if (last > generator.GetMaxGenerating()) {
+			last = generator.GetMaxGenerating();
+		}
+		if (first > last) {
+			first = last;
+		}
+	}
+
+	Iterator begin() const { return Iterator(generator, first); }
+	Iterator end() const { return Iterator(generator, last); }
+	Word size() const { return last - first; }
+	bool empty() const { return first == last; }
+	Point operator[](Word offset) const { return *Iterator(generator, first + offset); }
+
+private:
+	const Generator *generator;
+	Word first, last;
+};
+
+#endif //SOBOL_RANGE_H
\ No newline at end of file
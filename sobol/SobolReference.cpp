@@ -0,0 +1,136 @@
+#include "pch.h"
+
+// Frances Y. Kuo
+//
+// Email: <f.kuo@unsw.edu.au>
+// School of Mathematics and Statistics
+// University of New South Wales
+// Sydney NSW 2052, Australia
+// 
+// Last updated: 21 October 2008
+//
+//   You may incorporate this source code into your own program 
+//   provided that you
+//   1) acknowledge the copyright owner in your program and publication
+//   2) notify the copyright owner by email
+//   3) offer feedback regarding your experience with different direction numbers
+//
+//
+// -----------------------------------------------------------------------------
+// Licence pertaining to sobol.cc and the accompanying sets of direction numbers
+// -----------------------------------------------------------------------------
+// Copyright (c) 2008, Frances Y. Kuo and Stephen Joe
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+// 
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+// 
+//     * Neither the names of the copyright holders nor the names of the
+//       University of New South Wales and the University of Waikato
+//       and its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// -----------------------------------------------------------------------------
+
+#include <fstream>
+#include "SobolReference.h"
+
+SobolReference::SobolReference() : dimensions(0), bits(32), index(0) {
+}
+
+bool SobolReference::Open(const char *dirFile, unsigned int dimensions, unsigned int bits) {
+	this->dimensions = 0;
+	ifstream infile(dirFile, ios::in);
+	if (!infile || 0 == dimensions) {
+		return false;
+	}
+	char buffer[1000];
+	infile.getline(buffer, 1000, '\n');
+
+	const unsigned int stride = MaxBits + 1;
+	V.assign((size_t)dimensions * stride, 0);
+
+	// ----- Compute the first dimension -----
+	for (unsigned int i = 1; i <= MaxBits; i++) V[i] = (uint64_t)1 << (MaxBits - i); // all m's = 1
+
+	// ----- Compute the remaining dimensions -----
+	for (unsigned int j = 1; j <= dimensions - 1; j++) {
+		// Read in parameters from file
+		unsigned int d, s;
+		unsigned int a;
+		if (!(infile >> d >> s >> a)) {
+			return false;
+		}
+		vector<uint64_t> m(s + 1);
+		for (unsigned int i = 1; i <= s; i++) infile >> m[i];
+
+		// Compute direction numbers V[1] to V[MaxBits], scaled by pow(2,64)
+		uint64_t *column = V.data() + (size_t)j * stride;
+		if (MaxBits <= s) {
+			for (unsigned int i = 1; i <= MaxBits; i++) column[i] = m[i] << (MaxBits - i);
+		}
+		else {
+			for (unsigned int i = 1; i <= s; i++) column[i] = m[i] << (MaxBits - i);
+			for (unsigned int i = s + 1; i <= MaxBits; i++) {
+				column[i] = column[i - s] ^ (column[i - s] >> s);
+				for (unsigned int k = 1; k <= s - 1; k++)
+					column[i] ^= (((a >> (s - 1 - k)) & 1) * column[i - k]);
+			}
+		}
+	}
+	if (!infile) {
+		return false;
+	}
+
+	this->dimensions = dimensions;
+	this->bits = bits;
+	Restart();
+	return true;
+}
+
+void SobolReference::Restart() {
+	X.assign(dimensions, 0);
+	index = 0;
+}
+
+uint64_t SobolReference::Generate(double *points, uint64_t count, SobolLayout layout) {
+	const unsigned int stride = MaxBits + 1;
+	const size_t pointStride = SobolLayout::PointMajor == layout ? dimensions : 1;
+	const size_t dimensionStride = SobolLayout::PointMajor == layout ? 1 : (size_t)count;
+	for (uint64_t i = 0; i < count; i++, index++) {
+		if (0 != index) {
+			// C = index from the right of the first zero bit of index - 1
+			unsigned int C = 1;
+			uint64_t value = index - 1;
+			while (value & 1) {
+				value >>= 1;
+				C++;
+			}
+			for (unsigned int j = 0; j <= dimensions - 1; j++) X[j] ^= V[(size_t)j * stride + C];
+		}
+
+		double *point = points + (size_t)i * pointStride;
+		for (unsigned int j = 0; j <= dimensions - 1; j++) {
+			// *** the actual points, at the precision of the generator checked
+			point[j * dimensionStride] = 32 == bits ? (double)(X[j] >> 32) / 4294967296.0 : (double)(X[j] >> 11) / 9007199254740992.0;
+		}
+	}
+	return count;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#ifndef SOBOL_REFERENCE_H
+#define SOBOL_REFERENCE_H
+
+#include <cstdint>
+#include <vector>
+#include "SobolGenerator.h"
+
+using namespace std;
+
+// The Sobol generator of Joe and Kuo (sobol.cc), kept as the correctness oracle of BasicSobolGenerator: it reads the
+// direction numbers from their text file and steps through the Gray code order one point at a time, sharing none of
+// the tables, kernels or skip-ahead of the engine.
+// Instead of one row allocation per point plus index-sized scratch arrays, it carries only the current point
+// between calls and writes consecutive chunks of the sequence into a caller buffer, so any length can be checked in
+// bounded memory. It works on 64 bit words and converts to the precision of the generator under test.
+class SobolReference {
+public:
+	SobolReference();
+
+	// Reads the direction numbers of the first dimensions dimensions from dirFile, in the text format of Joe and Kuo,
+	// and restarts the sequence. bits is 32 to check SobolGenerator, 64 to check SobolGenerator64. Returns false if
+	// the file cannot be read or holds fewer dimensions.
+	bool Open(const char *dirFile, unsigned int dimensions, unsigned int bits = 32);
+
+	unsigned int GetDimensions() const { return dimensions; }
+	// Index of the next point Generate writes.
+	uint64_t GetIndex() const { return index; }
+	// Writes the next count points into points, which must hold count * GetDimensions() values laid out as
+	// BasicSobolGenerator::GetBlock does. Returns count.
+	uint64_t Generate(double *points, uint64_t count, SobolLayout layout = SobolLayout::PointMajor);
+	void Restart();
+
+private:
+	static const unsigned int MaxBits = 64;
+
+	unsigned int dimensions, bits;
+	// V[j * (MaxBits + 1) + i] is V[i] of dimension j + 1 scaled by 2^64, for i in [1, MaxBits].
+	vector<uint64_t> V;
+	// The point before index, scaled by 2^64.
+	vector<uint64_t> X;
+	uint64_t index;
+};
+
+#endif //SOBOL_REFERENCE_H
\ No newline at end of file
@@ -0,0 +1,34 @@
+#include "pch.h"
+
+#include "SobolSharedSource.h"
+
+template <typename Word>
+BasicSharedSobolSource<Word>::BasicSharedSobolSource(Word maxGenerating, unsigned short dimensions, Word blockSize, const DirectionSet& directionSet)
+	: prototype(maxGenerating, dimensions, directionSet), nextTicket(0) {
+	this->blockSize = 0 == blockSize ? 1 : blockSize;
+	blockCount = maxGenerating / this->blockSize + (0 != maxGenerating % this->blockSize ? 1 : 0);
+}
+
+template <typename Word>
+BasicSharedSobolSource<Word>::Consumer::Consumer(BasicSharedSobolSource& source)
+	: source(source), generator(source.prototype), nextIndex(0) {
+}
+
+template <typename Word>
+Word BasicSharedSobolSource<Word>::Consumer::Next(double *points, Word& begin, SobolLayout layout) {
+	uint64_t ticket = source.nextTicket.fetch_add(1, memory_order_relaxed);
+	if (ticket >= source.blockCount) {
+		return 0;
+	}
+
+	begin = (Word)ticket * source.blockSize;
+	if (begin != nextIndex) {
+		generator.Seek(begin);
+	}
+	Word count = generator.GetBlock(points, source.blockSize, layout);
+	nextIndex = begin + count;
+	return count;
+}
+
+template class BasicSharedSobolSource<uint32_t>;
+template class BasicSharedSobolSource<uint64_t>;
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#ifndef SOBOL_SHARED_SOURCE_H
+#define SOBOL_SHARED_SOURCE_H
+
+#include <atomic>
+#include "SobolGenerator.h"
+
+// A Sobol sequence shared by any number of consumer threads without locking. The sequence is cut into blocks of
+// blockSize points and a consumer claims the next block by taking a ticket from an atomic counter, then generates
+// it with its own generator seeked to the start of the block. Every point is handed out exactly once, and the
+// index returned with each block keeps the global ordering recoverable.
+//   BasicSharedSobolSource<uint32_t> source(1 << 20, 3);
+//   // On each worker thread:
+//   SharedSobolSource::Consumer consumer(source);
+//   uint32_t begin;
+//   while (uint32_t count = consumer.Next(points, begin)) { ... }
+template <typename Word>
+class BasicSharedSobolSource {
+public:
+	// Claims blocks of a source on behalf of a single thread. Consumers of the same source can run concurrently,
+	// a consumer itself must not be shared between threads.
+	class Consumer {
+	public:
+		explicit Consumer(BasicSharedSobolSource& source);
+
+		// Claims the next free block and writes its points into points, which must hold GetBlockSize() * dimensions
+		// values laid out as BasicSobolGenerator::GetBlock does. begin receives the index of the first point.
+		// Returns the number of points written, 0 once the sequence is exhausted.
+		Word Next(double *points, Word& begin, SobolLayout layout = SobolLayout::PointMajor);
+
+	private:
+		BasicSharedSobolSource& source;
+		BasicSobolGenerator<Word> generator;
+		// Index the generator is positioned at, so that consecutive blocks claimed by the same consumer skip the Seek.
+		Word nextIndex;
+	};
+
+	BasicSharedSobolSource(Word maxGenerating, unsigned short dimensions, Word blockSize = 256, const DirectionSet& directionSet = globalNewJoeKuo621201);
+	BasicSharedSobolSource(const BasicSharedSobolSource&) = delete;
+	BasicSharedSobolSource& operator=(const BasicSharedSobolSource&) = delete;
+
+	Word GetMaxGenerating() const { return prototype.GetMaxGenerating(); }
+	unsigned short GetDimensions() const { return prototype.GetDimensions(); }
+	Word GetBlockSize() const { return blockSize; }
+	// Same as BasicSobolGenerator::Scramble, for the consumers created afterwards.
+	void Scramble(SobolScrambling scrambling, uint64_t seed = 0) { prototype.Scramble(scrambling, seed); }
+	// Hands the sequence out again from index 0. Must not run concurrently with any consumer.
+	void Reset() { nextTicket.store(0, memory_order_relaxed); }
+
+private:
+	BasicSobolGenerator<Word> prototype;
+	Word blockSize;
+	uint64_t blockCount;
+	// Keeps counting past blockCount once exhausted, 64 bits so that it never wraps around in practice.
+	atomic<uint64_t> nextTicket;
+};
+
+typedef BasicSharedSobolSource<uint32_t> SharedSobolSource;
+typedef BasicSharedSobolSource<uint64_t> SharedSobolSource64;
+
+#endif //SOBOL_SHARED_SOURCE_H
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "pch.h"
+
+#include <cstring>
+#include "SobolKernels.h"
+#include "SobolStream.h"
+
+template <typename Word>
+BasicSobolStream<Word>::BasicSobolStream(const BasicSobolGenerator<Word>& generator, SobolSplit split, unsigned int stream, unsigned int streams)
+	: generator(generator), position(0), X(nullptr) {
+	const Word maxGenerating = generator.GetMaxGenerating();
+	if (SobolSplit::Blocked == split) {
+		// [stream * maxGenerating / streams, (stream + 1) * maxGenerating / streams), spelled out to avoid overflow.
+		Word remainder = maxGenerating % streams;
+		first = maxGenerating / streams * stream + (stream < remainder ? stream : remainder);
+		length = maxGenerating / streams + (stream < remainder ? 1 : 0);
+		stride = 1;
+		this->generator.Seek(first);
+	}
+	else {
+		first = stream;
+		length = stream < maxGenerating ? (maxGenerating - stream - 1) / streams + 1 : 0;
+		stride = streams;
+		X = new Word[generator.GetDimensions()];
+		Seek(0);
+	}
+}
+
+template <typename Word>
+BasicSobolStream<Word>::BasicSobolStream(const BasicSobolStream& other)
+	: generator(other.generator), first(other.first), stride(other.stride), length(other.length), position(other.position), X(nullptr) {
+	if (nullptr != other.X) {
+		X = new Word[generator.GetDimensions()];
+		memcpy(X, other.X, sizeof(Word) * generator.GetDimensions());
+	}
+}
+
+template <typename Word>
+BasicSobolStream<Word>::~BasicSobolStream() {
+	delete[] X;
+}
+
+template <typename Word>
+bool BasicSobolStream<Word>::GetNext(vector<double>& point) {
+	if (position == length) {
+		return false;
+	}
+
+	auto offset = point.size();
+	point.resize(offset + generator.GetDimensions());
+	return GetNext(point.data() + offset);
+}
+
+template <typename Word>
+Word BasicSobolStream<Word>::GetBlock(double *points, Word count) {
+	if (length - position < count) {
+		count = length - position;
+	}
+	if (nullptr == X) {
+		count = generator.GetBlock(points, count);
+		position += count;
+		return count;
+	}
+
+	const unsigned short dimensions = generator.GetDimensions();
+	const Word *rows[BasicSobolGenerator<Word>::Bits];
+	for (Word i = 0; i < count; ++i, points += dimensions) {
+		generator.ToUnit(X, points);
+		if (++position == length) {
+			break;
+		}
+		// Step from index n to n + stride: the Gray codes of the two differ by grayCode(n) ^ grayCode(n + stride).
+		Word index = GetIndex(position - 1), next = index + stride;
+		generator.Reserve(next + 1);
+		unsigned int rowCount = generator.GetRows(index ^ (index >> 1) ^ next ^ (next >> 1), rows);
+		for (unsigned int r = 0; r < rowCount; ++r) {
+			SobolKernels::Xor(X, rows[r], dimensions);
+		}
+	}
+	return count;
+}
+
+template <typename Word>
+bool BasicSobolStream<Word>::Seek(Word position) {
+	if (position > length) {
+		return false;
+	}
+
+	this->position = position;
+	if (nullptr == X) {
+		return generator.Seek(GetIndex(position));
+	}
+
+	memset(X, 0, sizeof(Word) * generator.GetDimensions());
+	if (position < length) {
+		generator.Reserve(GetIndex(position) + 1);
+		const Word *rows[BasicSobolGenerator<Word>::Bits];
+		unsigned int rowCount = generator.GetGrayCodeRows(GetIndex(position), rows);
+		for (unsigned int r = 0; r < rowCount; ++r) {
+			SobolKernels::Xor(X, rows[r], generator.GetDimensions());
+		}
+	}
+	return true;
+}
+
+template class BasicSobolStream<uint32_t>;
+template class BasicSobolStream<uint64_t>;
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#ifndef SOBOL_STREAM_H
+#define SOBOL_STREAM_H
+
+#include "SobolGenerator.h"
+
+// How a Sobol sequence is split into streams.
+enum class SobolSplit {
+	// Stream s of S gets the contiguous indices [s * maxGenerating / S, (s + 1) * maxGenerating / S).
+	Blocked,
+	// Stream s of S gets the indices s, s + S, s + 2S... Every stream then spans the whole sequence, but with a
+	// coarser stratification, best with a power of two S.
+	Leapfrog
+};
+
+// One of several disjoint streams of a Sobol sequence. The streams of a split never share a point and each one
+// only depends on the sequence and its own stream number, so subsystems can draw from their own stream in any order
+// or on any thread and still get reproducible points, without replaying the sequence from index 0.
+template <typename Word>
+class BasicSobolStream {
+public:
+	// generator is copied, its position does not matter. streams must not be 0 and stream must be below it.
+	BasicSobolStream(const BasicSobolGenerator<Word>& generator, SobolSplit split, unsigned int stream, unsigned int streams);
+	BasicSobolStream(const BasicSobolStream& other);
+	~BasicSobolStream();
+	BasicSobolStream& operator=(const BasicSobolStream&) = delete;
+
+	unsigned short GetDimensions() const { return generator.GetDimensions(); }
+	// Number of points in the stream.
+	Word GetLength() const { return length; }
+	// Number of points of the stream already returned.
+	Word GetPosition() const { return position; }
+	// Index in the whole sequence of the point at the given position of the stream.
+	Word GetIndex(Word position) const { return first + position * stride; }
+	bool GetNext(vector<double>& point);
+	bool GetNext(double *point) { return 1 == GetBlock(point, 1); }
+	// Writes up to count following points of the stream into points, laid out point-major.
+	// Returns the number of points written, less than count only when the stream is exhausted.
+	Word GetBlock(double *points, Word count);
+	// Positions the stream so that the next point returned is the one at position, in O(requiredBits * dimensions).
+	// Returns false, leaving the stream untouched, when position is past the length.
+	bool Seek(Word position);
+
+private:
+	BasicSobolGenerator<Word> generator;
+	Word first, stride, length, position;
+	// Leapfrog only: the scaled point at GetIndex(position), the generator itself only steps one index at a time.
+	Word *X;
+};
+
+typedef BasicSobolStream<uint32_t> SobolStream;
+typedef BasicSobolStream<uint64_t> SobolStream64;
+
+#endif //SOBOL_STREAM_H
\ No newline at end of file
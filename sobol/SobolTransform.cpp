@@ -0,0 +1,152 @@
+#include "pch.h"
+
+#include "SobolTransform.h"
+
+namespace {
+	const double twoPi = 6.283185307179586476925286766559;
+
+	// Acklam's approximation, https://web.archive.org/web/20151030215612/http://home.online.no/~pjacklam/notes/invnorm/
+	double InverseNormal(double p) {
+		const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+		const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01 };
+		const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+		const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00, 3.754408661907416e+00 };
+		const double low = 0.02425, high = 1.0 - low;
+
+		if (p < low) {
+			double q = sqrt(-2.0 * log(p));
+			return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+		}
+		if (p > high) {
+			double q = sqrt(-2.0 * log(1.0 - p));
+			return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+		}
+		double q = p - 0.5, r = q * q;
+		return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+	}
+}
+
+SobolTransform::SobolTransform() : inputDimensions(0), outputDimensions(0) {
+}
+
+SobolTransform::Stage& SobolTransform::AddStage(SobolMapping mapping, unsigned short inputs, unsigned short outputs) {
+	Stage stage;
+	stage.mapping = mapping;
+	stage.input = inputDimensions;
+	stage.output = outputDimensions;
+	stage.dimensions = inputs;
+	inputDimensions += inputs;
+	outputDimensions += outputs;
+	stages.push_back(stage);
+	return stages.back();
+}
+
+SobolTransform& SobolTransform::Affine(unsigned short dimensions, const double *lower, const double *upper) {
+	Stage& stage = AddStage(SobolMapping::Affine, dimensions, dimensions);
+	stage.parameters.resize(2 * (size_t)dimensions);
+	for (unsigned short j = 0; j < dimensions; ++j) {
+		stage.parameters[j] = lower[j];
+		stage.parameters[dimensions + j] = upper[j] - lower[j];
+	}
+	return *this;
+}
+
+SobolTransform& SobolTransform::Disk(double radius, double innerRadius, double centerX, double centerY) {
+	Stage& stage = AddStage(SobolMapping::Disk, 2, 2);
+	stage.parameters = { innerRadius * innerRadius, radius * radius - innerRadius * innerRadius, centerX, centerY };
+	return *this;
+}
+
+SobolTransform& SobolTransform::Sphere(double radius, double centerX, double centerY, double centerZ) {
+	Stage& stage = AddStage(SobolMapping::Sphere, 2, 3);
+	stage.parameters = { radius, centerX, centerY, centerZ };
+	return *this;
+}
+
+SobolTransform& SobolTransform::Normal(unsigned short dimensions, double mean, double deviation) {
+	Stage& stage = AddStage(SobolMapping::Normal, dimensions, dimensions);
+	stage.parameters = { mean, deviation };
+	return *this;
+}
+
+void SobolTransform::Apply(const double *unit, size_t count, double *points, size_t dimensionStride, unsigned int bits) const {
+	if (0 == dimensionStride) {
+		dimensionStride = count;
+	}
+	// Stands for the point 0 in the inverse normal CDF, half the resolution of the sequence.
+	const double zeroQuantile = ldexp(1.0, -(int)bits - 1);
+	const size_t stride = outputDimensions;
+	for (auto stage = stages.begin(); stage != stages.end(); ++stage) {
+		const double *in = unit + stage->input * dimensionStride;
+		double *out = points + stage->output;
+		const double *parameters = stage->parameters.data();
+
+		switch (stage->mapping) {
+		case SobolMapping::Affine:
+			for (unsigned short j = 0; j < stage->dimensions; ++j) {
+				const double lower = parameters[j], scale = parameters[stage->dimensions + j];
+				const double *column = in + j * dimensionStride;
+				for (size_t i = 0; i < count; ++i) {
+					out[i * stride + j] = lower + column[i] * scale;
+				}
+			}
+			break;
+
+		case SobolMapping::Disk:
+			for (size_t i = 0; i < count; ++i) {
+				double r = sqrt(parameters[0] + in[i] * parameters[1]);
+				double theta = twoPi * in[dimensionStride + i];
+				out[i * stride] = parameters[2] + r * cos(theta);
+				out[i * stride + 1] = parameters[3] + r * sin(theta);
+			}
+			break;
+
+		case SobolMapping::Sphere:
+			for (size_t i = 0; i < count; ++i) {
+				double z = 1.0 - 2.0 * in[i];
+				double r = sqrt(fmax(0.0, 1.0 - z * z));
+				double phi = twoPi * in[dimensionStride + i];
+				out[i * stride] = parameters[1] + parameters[0] * r * cos(phi);
+				out[i * stride + 1] = parameters[2] + parameters[0] * r * sin(phi);
+				out[i * stride + 2] = parameters[3] + parameters[0] * z;
+			}
+			break;
+
+		case SobolMapping::Normal:
+			for (unsigned short j = 0; j < stage->dimensions; ++j) {
+				const double *column = in + j * dimensionStride;
+				for (size_t i = 0; i < count; ++i) {
+					double p = 0.0 < column[i] ? column[i] : zeroQuantile;
+					out[i * stride + j] = parameters[0] + parameters[1] * InverseNormal(p);
+				}
+			}
+			break;
+		}
+	}
+}
+
+template <typename Word>
+Word SobolTransform::GenerateChunks(BasicSobolGenerator<Word>& generator, double *points, Word count) const {
+	if (generator.GetDimensions() != inputDimensions) {
+		return 0;
+	}
+
+	// A double keeps at most 53 bits of a word, see SobolWord<uint64_t>::ToUnit.
+	const unsigned int bits = SobolWord<Word>::Bits < 53 ? SobolWord<Word>::Bits : 53;
+	vector<double> chunk((size_t)chunkSize * inputDimensions);
+	Word generated = 0;
+	while (generated < count) {
+		Word chunkCount = count - generated < chunkSize ? count - generated : chunkSize;
+		// The columns stay chunkSize apart even when the generator runs out within the chunk and returns fewer.
+		chunkCount = generator.GetBlock(chunk.data(), chunkCount, SobolLayout::DimensionMajor, chunkSize);
+		if (0 == chunkCount) {
+			break;
+		}
+		Apply(chunk.data(), (size_t)chunkCount, points + (size_t)generated * outputDimensions, chunkSize, bits);
+		generated += chunkCount;
+	}
+	return generated;
+}
+
+template uint32_t SobolTransform::GenerateChunks<uint32_t>(BasicSobolGenerator<uint32_t>&, double *, uint32_t) const;
+template uint64_t SobolTransform::GenerateChunks<uint64_t>(BasicSobolGenerator<uint64_t>&, double *, uint64_t) const;
\ No newline at end of file
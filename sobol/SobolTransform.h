@@ -0,0 +1,80 @@
+#pragma once
+
+#ifndef SOBOL_TRANSFORM_H
+#define SOBOL_TRANSFORM_H
+
+#include "SobolGenerator.h"
+
+// Mappings from the unit cube a SobolTransform chains together.
+enum class SobolMapping {
+	// x -> lower + x * (upper - lower), dimension by dimension
+	Affine,
+	// 2 dimensions -> a point of a disk or annulus
+	Disk,
+	// 2 dimensions -> a point of a sphere, 3 outputs
+	Sphere,
+	// x -> the inverse normal CDF of x, dimension by dimension
+	Normal
+};
+
+// Maps Sobol points from the unit cube to the distributions the consumers want, fused with the generation: the
+// points are generated a chunk at a time into a small dimension-major buffer that stays in cache, and every mapping
+// runs over whole columns of it, so there is no second pass over a full block of unit points. Only the affine
+// mapping is a loop the compiler vectorizes; the others call sqrt, log, sin or cos per value, and the normal one
+// branches on the tails, which the compilers keep scalar without vector math libraries.
+// The mappings consume the input dimensions in the order they are added and append their outputs in that order:
+//   SobolTransform islands;
+//   islands.Disk(radius, 0.0, centerX, centerY).Affine(1, &lowest, &highest); // x, y, then height
+//   islands.Generate(generator, sites, count); // generator has islands.GetInputDimensions() dimensions
+class SobolTransform {
+public:
+	SobolTransform();
+
+	// lower and upper hold one bound for each of the next dimensions.
+	SobolTransform& Affine(unsigned short dimensions, const double *lower, const double *upper);
+	// Uniform on the disk of the given radius, or on the annulus between innerRadius and radius. The first input
+	// dimension picks the squared radius and the second the angle, so the mapping preserves areas and the
+	// stratification of the sequence.
+	SobolTransform& Disk(double radius, double innerRadius = 0.0, double centerX = 0.0, double centerY = 0.0);
+	// Uniform on the sphere of the given radius by Archimedes' projection: the first input dimension picks the height
+	// and the second the longitude, again preserving areas.
+	SobolTransform& Sphere(double radius = 1.0, double centerX = 0.0, double centerY = 0.0, double centerZ = 0.0);
+	// Normally distributed with Acklam's rational approximation of the inverse CDF, relative error below 1.15e-9.
+	// A coordinate of 0, which every Sobol sequence starts with, is taken as half the resolution of the generator,
+	// 2^-33 for 32 bit words and 2^-54 for 64 bit ones, rather than mapped to -infinity.
+	SobolTransform& Normal(unsigned short dimensions, double mean = 0.0, double deviation = 1.0);
+
+	unsigned short GetInputDimensions() const { return inputDimensions; }
+	unsigned short GetOutputDimensions() const { return outputDimensions; }
+
+	// Maps count unit points laid out dimension-major, unit[j * dimensionStride + i], into points laid out
+	// point-major with GetOutputDimensions() values each. dimensionStride defaults to count. bits is the resolution
+	// of the unit points, multiples of 2^-bits, which sets the value a coordinate of 0 stands for in Normal.
+	void Apply(const double *unit, size_t count, double *points, size_t dimensionStride = 0, unsigned int bits = 32) const;
+	// Generates the next count points of generator mapped into points, which must hold count *
+	// GetOutputDimensions() values. Returns the number of points written, 0 if generator does not have
+	// GetInputDimensions() dimensions.
+	uint32_t Generate(SobolGenerator& generator, double *points, uint32_t count) const { return GenerateChunks(generator, points, count); }
+	uint64_t Generate(SobolGenerator64& generator, double *points, uint64_t count) const { return GenerateChunks(generator, points, count); }
+
+private:
+	struct Stage {
+		SobolMapping mapping;
+		unsigned short input, output, dimensions;
+		// Affine: lower then scale of every dimension. Disk: squared inner radius, squared radius span, center.
+		// Sphere: radius, center. Normal: mean, deviation.
+		vector<double> parameters;
+	};
+
+	Stage& AddStage(SobolMapping mapping, unsigned short inputs, unsigned short outputs);
+	template <typename Word>
+	Word GenerateChunks(BasicSobolGenerator<Word>& generator, double *points, Word count) const;
+
+	// Points per chunk of Generate, the buffer of a chunk is chunkSize * GetInputDimensions() doubles.
+	static const unsigned int chunkSize = 256;
+
+	vector<Stage> stages;
+	unsigned short inputDimensions, outputDimensions;
+};
+
+#endif //SOBOL_TRANSFORM_H
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "SobolVerifier.h"
+#include "SobolGenerator.h"
+#include "SobolParallelGenerator.h"
+#include "SobolReference.h"
+#include "SobolStream.h"
+
+namespace {
+	const unsigned int leapfrogStreams = 4;
+
+	uint64_t HashWords(uint64_t hash, const uint64_t *words, size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			hash = (hash ^ words[i]) * 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	// Generates the sequence in one SobolVerifyMode, in consecutive chunks of raw words.
+	class ModeSource {
+	public:
+		virtual ~ModeSource() {}
+
+		virtual bool IsOpened() const = 0;
+		// Writes the points [begin, begin + count) point-major into words. begin is where the previous call ended.
+		virtual void Generate(uint64_t *words, uint32_t begin, uint32_t count) = 0;
+	};
+
+	template <typename Word>
+	class BasicModeSource : public ModeSource {
+	public:
+		BasicModeSource(SobolVerifyMode mode, uint32_t count, unsigned short dimensions, const SobolVerifyOptions& options)
+			: mode(mode), dimensions(dimensions), generator(count, dimensions), scrambling(options.scrambling), opened(true) {
+			generator.Scramble(options.scrambling, options.seed);
+			switch (mode) {
+			case SobolVerifyMode::Reference:
+				opened = reference.Open(options.referenceFile.c_str(), dimensions, Bits);
+				for (unsigned short j = 0; j < dimensions; ++j) {
+					scrambleKeys.push_back(SobolScrambling::None == scrambling ? 0 : SobolScrambleKey<Word>(options.seed, j));
+				}
+				break;
+			case SobolVerifyMode::Parallel:
+				parallel.reset(new BasicParallelSobolGenerator<Word>(count, dimensions, options.threads));
+				parallel->Scramble(options.scrambling, options.seed);
+				break;
+			case SobolVerifyMode::Leapfrog:
+				for (unsigned int stream = 0; stream < leapfrogStreams; ++stream) {
+					streams.push_back(BasicSobolStream<Word>(generator, SobolSplit::Leapfrog, stream, leapfrogStreams));
+				}
+				break;
+			default:
+				break;
+			}
+			if (SobolVerifyMode::Block == mode) {
+				blockWords.resize((size_t)options.chunkSize * dimensions);
+			}
+			else {
+				points.resize((size_t)options.chunkSize * dimensions);
+			}
+		}
+
+		bool IsOpened() const { return opened; }
+
+		void Generate(uint64_t *words, uint32_t begin, uint32_t count) {
+			const size_t n = (size_t)count * dimensions;
+			switch (mode) {
+			case SobolVerifyMode::Reference:
+				// The reference knows nothing of scrambling, its words are scrambled here with the scalar
+				// SobolScramble. The bits a double drops from a 64 bit word only depend on the bits below them, so
+				// scrambling the truncated word matches the generators.
+				reference.Generate(points.data(), count);
+				for (size_t i = 0; i < n; ++i) {
+					words[i] = ToPrecision(SobolScramble(scrambling, ToWord(points[i]), scrambleKeys[i % dimensions]));
+				}
+				break;
+			case SobolVerifyMode::Serial:
+				for (uint32_t i = 0; i < count; ++i) {
+					point.clear();
+					generator.GetNext(point);
+					ToWords(point.data(), words + (size_t)i * dimensions, dimensions);
+				}
+				break;
+			case SobolVerifyMode::Block:
+				generator.GetBlock(blockWords.data(), count);
+				for (size_t i = 0; i < n; ++i) {
+					words[i] = ToPrecision(blockWords[i]);
+				}
+				break;
+			case SobolVerifyMode::DoubleBlock:
+				generator.GetBlock(points.data(), count);
+				ToWords(points.data(), words, n);
+				break;
+			case SobolVerifyMode::Parallel:
+				parallel->Generate(points.data(), begin, count);
+				ToWords(points.data(), words, n);
+				break;
+			case SobolVerifyMode::SkipAhead: {
+				// An odd split point, so that the seeks land on every kind of Gray code.
+				const uint32_t half = count / 2 | 1;
+				if (half < count) {
+					generator.Seek(begin + half);
+					generator.GetBlock(points.data() + (size_t)half * dimensions, count - half);
+				}
+				generator.Seek(begin);
+				generator.GetBlock(points.data(), min(half, count));
+				ToWords(points.data(), words, n);
+				break;
+			}
+			case SobolVerifyMode::PointAt:
+				for (uint32_t i = 0; i < count; ++i) {
+					generator.PointAt(begin + i, points.data() + (size_t)i * dimensions);
+				}
+				ToWords(points.data(), words, n);
+				break;
+			case SobolVerifyMode::Leapfrog:
+				// begin is a multiple of the number of streams, stream s holds the indices s modulo that number.
+				for (unsigned int stream = 0; stream < leapfrogStreams; ++stream) {
+					const uint32_t streamCount = count > stream ? (count - stream + leapfrogStreams - 1) / leapfrogStreams : 0;
+					streams[stream].GetBlock(points.data(), streamCount);
+					for (uint32_t i = 0; i < streamCount; ++i) {
+						ToWords(points.data() + (size_t)i * dimensions, words + ((size_t)i * leapfrogStreams + stream) * dimensions, dimensions);
+					}
+				}
+				break;
+			}
+		}
+
+	private:
+		static const unsigned int Bits = SobolWord<Word>::Bits;
+		// Bits of a word a double keeps, see SobolWord<Word>::ToUnit.
+		static const unsigned int PreciseBits = Bits < 53 ? Bits : 53;
+
+		static Word ToPrecision(Word x) {
+			return x >> (Bits - PreciseBits) << (Bits - PreciseBits);
+		}
+
+		static Word ToWord(double x) {
+			// Exact, the doubles of the generators are words / 2^Bits cut to PreciseBits.
+			return (Word)ldexp(x, Bits);
+		}
+
+		static void ToWords(const double *points, uint64_t *words, size_t n) {
+			for (size_t i = 0; i < n; ++i) {
+				words[i] = ToWord(points[i]);
+			}
+		}
+
+		SobolVerifyMode mode;
+		unsigned short dimensions;
+		BasicSobolGenerator<Word> generator;
+		SobolScrambling scrambling;
+		vector<Word> scrambleKeys;
+		unique_ptr<BasicParallelSobolGenerator<Word>> parallel;
+		SobolReference reference;
+		vector<BasicSobolStream<Word>> streams;
+		// Scratch of the modes writing doubles, and of Block.
+		vector<double> points, point;
+		vector<Word> blockWords;
+		bool opened;
+	};
+
+	ModeSource *CreateModeSource(SobolVerifyMode mode, uint32_t count, unsigned short dimensions, const SobolVerifyOptions& options) {
+		if (64 == options.bits) {
+			return new BasicModeSource<uint64_t>(mode, count, dimensions, options);
+		}
+		return new BasicModeSource<uint32_t>(mode, count, dimensions, options);
+	}
+}
+
+SobolVerifyOptions::SobolVerifyOptions()
+	: chunkSize(1 << 16), threads(0), referenceFile("new-joe-kuo-6.21201"), bits(32), scrambling(SobolScrambling::None), seed(0) {
+}
+
+SobolVerifyResult VerifySobolModes(SobolVerifyMode first, SobolVerifyMode second, uint32_t count, unsigned short dimensions,
+	const SobolVerifyOptions& options, ostream *progress) {
+	SobolVerifyResult result = {};
+	result.firstHash = result.secondHash = 0xcbf29ce484222325ull;
+	if (0 == dimensions || dimensions > globalNewJoeKuo621201.dimensions) {
+		return result;
+	}
+
+	// Chunks stay a multiple of the leapfrog streams, and are cut down to the count and to 2^24 words per mode.
+	SobolVerifyOptions chunkOptions = options;
+	const uint32_t chunkLimit = min<uint32_t>(((1 << 24) / dimensions + 63) / 64 * 64, (uint32_t)min<uint64_t>((uint64_t)count + 63, 0xFFFFFFFFull) / 64 * 64);
+	chunkOptions.chunkSize = max<uint32_t>(64, min(chunkLimit, options.chunkSize / 64 * 64));
+	unique_ptr<ModeSource> firstSource(CreateModeSource(first, count, dimensions, chunkOptions));
+	unique_ptr<ModeSource> secondSource(CreateModeSource(second, count, dimensions, chunkOptions));
+	result.opened = firstSource->IsOpened() && secondSource->IsOpened();
+	if (!result.opened) {
+		return result;
+	}
+
+	const size_t chunkWords = (size_t)chunkOptions.chunkSize * dimensions;
+	vector<uint64_t> firstWords(chunkWords), secondWords(chunkWords);
+	const uint64_t progressPoints = max<uint64_t>(1, ((uint64_t)1 << 28) / dimensions);
+	uint64_t nextProgress = progressPoints;
+	result.identical = true;
+	for (uint32_t begin = 0; begin < count; ) {
+		const uint32_t chunk = min(chunkOptions.chunkSize, count - begin);
+		const size_t n = (size_t)chunk * dimensions;
+		firstSource->Generate(firstWords.data(), begin, chunk);
+		secondSource->Generate(secondWords.data(), begin, chunk);
+
+		const auto difference = mismatch(firstWords.begin(), firstWords.begin() + n, secondWords.begin());
+		if (firstWords.begin() + n != difference.first) {
+			const size_t word = difference.first - firstWords.begin();
+			const size_t verifiedWords = word / dimensions * dimensions;
+			result.identical = false;
+			result.verified = begin + word / dimensions;
+			result.mismatchIndex = result.verified;
+			result.mismatchDimension = (unsigned short)(word % dimensions);
+			result.firstWord = *difference.first;
+			result.secondWord = *difference.second;
+			result.firstHash = HashWords(result.firstHash, firstWords.data(), verifiedWords);
+			result.secondHash = HashWords(result.secondHash, secondWords.data(), verifiedWords);
+			return result;
+		}
+		result.firstHash = HashWords(result.firstHash, firstWords.data(), n);
+		result.secondHash = result.firstHash;
+		begin += chunk;
+		result.verified = begin;
+
+		if (nullptr != progress && result.verified >= nextProgress) {
+			*progress << "Verified " << result.verified << " of " << count << " points" << endl;
+			nextProgress = result.verified + progressPoints;
+		}
+	}
+	return result;
+}
+
+bool ParseSobolVerifyMode(const string& name, SobolVerifyMode& mode) {
+	const char *names[] = { "reference", "serial", "block", "doubleblock", "parallel", "skipahead", "pointat", "leapfrog" };
+	for (unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+		if (name == names[i]) {
+			mode = (SobolVerifyMode)i;
+			return true;
+		}
+	}
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#ifndef SOBOL_VERIFIER_H
+#define SOBOL_VERIFIER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include "SobolGenerator.h"
+
+using namespace std;
+
+// The ways of generating a Sobol sequence VerifySobolModes can compare.
+enum class SobolVerifyMode {
+	// SobolReference, the port of the program of Joe and Kuo
+	Reference,
+	// SobolGenerator::GetNext, one point at a time
+	Serial,
+	// SobolGenerator::GetBlock into raw words, through the vector kernels
+	Block,
+	// SobolGenerator::GetBlock into doubles, through the vector conversion kernels users call
+	DoubleBlock,
+	// ParallelSobolGenerator::Generate, one chunk at a time on every thread
+	Parallel,
+	// SobolGenerator::Seek, the second half of every chunk before the first
+	SkipAhead,
+	// SobolGenerator::PointAt on every index
+	PointAt,
+	// Four leapfrog SobolStream, interleaved back into the sequence
+	Leapfrog
+};
+
+struct SobolVerifyOptions {
+	SobolVerifyOptions();
+
+	// Points generated and compared at a time, rounded down to a multiple of 64 and cut down to about 2^24 words.
+	// The memory used is about 16 * chunkSize * dimensions bytes per mode, whatever the count.
+	uint32_t chunkSize;
+	// Threads of the Parallel mode, 0 uses one thread per hardware thread.
+	unsigned int threads;
+	// Direction numbers of the Reference mode, in the text format of Joe and Kuo.
+	string referenceFile;
+	// Word of the generators under test, 32 for SobolGenerator or 64 for SobolGenerator64. The 64 bit words are
+	// compared on the 53 high bits a double keeps.
+	unsigned int bits;
+	// Scrambling every mode applies. The Reference mode scrambles its words with the scalar SobolScramble.
+	SobolScrambling scrambling;
+	uint64_t seed;
+};
+
+struct SobolVerifyResult {
+	// false if a mode could not be set up, such as Reference without its direction file.
+	bool opened;
+	bool identical;
+	// Number of points found identical, before the first mismatch if any.
+	uint64_t verified;
+	// First differing coordinate, as the raw words of both modes.
+	uint64_t mismatchIndex;
+	unsigned short mismatchDimension;
+	uint64_t firstWord, secondWord;
+	// FNV-1a hashes, a word at a time, of the raw words of the verified points, point-major. Equal when identical, and a fingerprint of
+	// the sequence to compare against other builds and machines.
+	uint64_t firstHash, secondHash;
+};
+
+// Generates the first count points of the Sobol sequence of the given dimensions in two modes side by side, a chunk
+// at a time, and compares the raw words of every coordinate. Doubles convert back to words exactly, so every mode is
+// checked bit for bit, up to the 2^32 - 1 points a SobolGenerator can produce, in constant memory.
+// Unless progress is null, writes a line to it about every 2^28 coordinates.
+SobolVerifyResult VerifySobolModes(SobolVerifyMode first, SobolVerifyMode second, uint32_t count, unsigned short dimensions,
+	const SobolVerifyOptions& options = SobolVerifyOptions(), ostream *progress = nullptr);
+// Parses a mode from its name in lower case: reference, serial, block, doubleblock, parallel, skipahead, pointat or
+// leapfrog.
+bool ParseSobolVerifyMode(const string& name, SobolVerifyMode& mode);
+
+#endif //SOBOL_VERIFIER_H
\ No newline at end of file
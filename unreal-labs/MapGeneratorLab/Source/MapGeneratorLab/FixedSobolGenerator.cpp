@@ -0,0 +1,4 @@
+#include "FixedSobolGenerator.h"
+
+template class FixedSobolGenerator<2>;
+template class FixedSobolGenerator<3>;
\ No newline at end of file
@@ -74,12 +74,25 @@ void AMapPointGenerator::Generate() {
 	Reset();
 
 	UE_LOG(LogTemp, Log, TEXT("[AMapPointGenerator.Debug] In generation, previous map width [%f] current map width [%f] previous map height [%f] map height [%f]"), PreviousMapWidth, MapWidth, PreviousMapHeight, MapHeight);
-	auto Generator = new SobolGenerator(HowManyGenerating, 2);
-	vector<double> VectorFromSobol;
+	SobolCache Cache(TCHAR_TO_UTF8(*FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SobolCache"))));
+	SobolCache *SiteCache = IsCachingSites ? &Cache : nullptr;
+	SobolSiteSampler SobolSampler(SiteCache);
+	PoissonDiskSiteSampler PoissonDiskSampler(MinimumSiteSpacing);
+	WeightedEliminationSiteSampler WeightedEliminationSampler(5, SiteCache);
+	SiteSampler *Sampler = &SobolSampler;
+	if (EMapSiteSampling::PoissonDisk == SiteSampling) {
+		Sampler = &PoissonDiskSampler;
+	}
+	else if (EMapSiteSampling::WeightedElimination == SiteSampling) {
+		Sampler = &WeightedEliminationSampler;
+	}
+	vector<double> Sites;
+	const unsigned int SiteCount = Sampler->Sample(MapWidth, MapHeight, HowManyGenerating, (uint64_t)(uint32_t)MapSeed, Sites);
+
 	FVector SpawnLocation = FVector();
-	while (Generator->GetNext(VectorFromSobol)) {
-		SpawnLocation.X = VectorFromSobol[0] * MapWidth;
-		SpawnLocation.Y = VectorFromSobol[1] * MapHeight;
+	for (unsigned int i = 0; i < SiteCount; ++i) {
+		SpawnLocation.X = Sites[2 * i];
+		SpawnLocation.Y = Sites[2 * i + 1];
 		SpawnLocation.Z = ElementZ;
 
 		auto VPoint = VoronoiPoint{ SpawnLocation.X, SpawnLocation.Y };
@@ -87,8 +100,6 @@ void AMapPointGenerator::Generate() {
 		SiteVoronoiPoints.push_back(VPoint);
 
 		//UE_LOG(LogTemp, Log, TEXT("[AMapPointGenerator.Log] Spawn site (%f, %f)"), SpawnLocation.X, SpawnLocation.Y);
-
-		VectorFromSobol.clear();
 	}
 
 	sort(SiteVoronoiPoints.begin(), SiteVoronoiPoints.end());
@@ -10,7 +10,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 
-#include "SobolGenerator.h"
+#include "SiteSampler.h"
 #include "VoronoiDiagram/Fortune/Tomilov/sweepline.hpp"
 #include "MapPointGenerator.generated.h"
 
@@ -37,6 +37,17 @@ struct VoronoiEdge {
 
 using MapPointGeneratorSweepline = sweepline<vector<VoronoiPoint>::const_iterator, VoronoiPoint, double>;
 
+// How the sites of the map are drawn, see SiteSampler.h.
+UENUM(BlueprintType)
+enum class EMapSiteSampling : uint8 {
+	// Exactly HowManyGenerating sites, evenly spread but with no minimum spacing.
+	Sobol,
+	// Sites at least MinimumSiteSpacing apart until the map is full, about HowManyGenerating of them by default.
+	PoissonDisk,
+	// Exactly HowManyGenerating sites with blue noise spacing, eliminated from an oversampled Sobol set.
+	WeightedElimination
+};
+
 UCLASS()
 class MAPGENERATORLAB_API AMapPointGenerator : public AActor {
 	GENERATED_BODY()
@@ -53,6 +64,22 @@ public:
 	UPROPERTY(Category = Map, EditAnywhere, BlueprintReadWrite)
 	float MapHeight = 0.0;
 
+	// Scrambles the sites so that every seed gets its own layout, 0 keeps the plain Sobol sequence.
+	UPROPERTY(Category = Map, EditAnywhere, BlueprintReadWrite)
+	int32 MapSeed = 0;
+
+	UPROPERTY(Category = Map, EditAnywhere, BlueprintReadWrite)
+	EMapSiteSampling SiteSampling = EMapSiteSampling::Sobol;
+
+	// Minimum distance between the sites of the PoissonDisk sampler, 0 derives it from HowManyGenerating.
+	UPROPERTY(Category = Map, EditAnywhere, BlueprintReadWrite)
+	float MinimumSiteSpacing = 0.0;
+
+	// Keeps the generated Sobol points in Saved/SobolCache, so that regenerating the map, after a resize for
+	// instance, maps them back instead of computing them again.
+	UPROPERTY(Category = Map, EditAnywhere, BlueprintReadWrite)
+	bool IsCachingSites = true;
+
 	UPROPERTY(Category = Effects, EditAnywhere)
 	bool IsShowSiteLines = false;
 
@@ -0,0 +1,182 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifdef PLATFORM_WINDOWS
+// Within Unreal the Windows headers have to be wrapped, their macros clash with the engine's.
+#include "Windows/AllowWindowsPlatformTypes.h"
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#ifdef PLATFORM_WINDOWS
+#include "Windows/HideWindowsPlatformTypes.h"
+#endif
+#else
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() {
+	data = nullptr;
+	size = 0;
+	writable = false;
+#ifdef _WIN32
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = nullptr;
+#endif
+}
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+bool MappedFile::Open(const char *path, bool randomAccess) {
+	Close();
+
+#ifdef _WIN32
+	fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (INVALID_HANDLE_VALUE == fileHandle) {
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || 0 == fileSize.QuadPart) {
+		Close();
+		return false;
+	}
+
+	mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (nullptr == mappingHandle) {
+		Close();
+		return false;
+	}
+
+	data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (nullptr == data) {
+		Close();
+		return false;
+	}
+	size = (size_t)fileSize.QuadPart;
+#else
+	int descriptor = open(path, O_RDONLY);
+	if (descriptor < 0) {
+		return false;
+	}
+
+	struct stat status;
+	if (0 != fstat(descriptor, &status) || 0 == status.st_size) {
+		close(descriptor);
+		return false;
+	}
+
+	void *mapping = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+	// The mapping keeps its own reference to the file.
+	close(descriptor);
+	if (MAP_FAILED == mapping) {
+		return false;
+	}
+
+	if (randomAccess) {
+		posix_madvise(mapping, (size_t)status.st_size, POSIX_MADV_RANDOM);
+	}
+
+	data = mapping;
+	size = (size_t)status.st_size;
+#endif
+	return true;
+}
+
+bool MappedFile::Create(const char *path, size_t size) {
+	Close();
+	if (0 == size) {
+		return false;
+	}
+
+#ifdef _WIN32
+	fileHandle = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (INVALID_HANDLE_VALUE == fileHandle) {
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	fileSize.QuadPart = (LONGLONG)size;
+	mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READWRITE, fileSize.HighPart, fileSize.LowPart, nullptr);
+	if (nullptr == mappingHandle) {
+		Close();
+		return false;
+	}
+
+	data = MapViewOfFile(mappingHandle, FILE_MAP_WRITE, 0, 0, 0);
+	if (nullptr == data) {
+		Close();
+		return false;
+	}
+#else
+	int descriptor = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (descriptor < 0) {
+		return false;
+	}
+
+	if (0 != ftruncate(descriptor, (off_t)size)) {
+		close(descriptor);
+		return false;
+	}
+
+	void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+	close(descriptor);
+	if (MAP_FAILED == mapping) {
+		return false;
+	}
+
+	// Written front to back, once.
+	posix_madvise(mapping, size, POSIX_MADV_SEQUENTIAL);
+	data = mapping;
+#endif
+	this->size = size;
+	writable = true;
+	return true;
+}
+
+bool MappedFile::Flush() {
+	if (!writable) {
+		return false;
+	}
+#ifdef _WIN32
+	return FlushViewOfFile(data, 0) && FlushFileBuffers(fileHandle);
+#else
+	return 0 == msync(const_cast<void *>(data), size, MS_SYNC);
+#endif
+}
+
+bool MappedFile::Replace(const char *from, const char *to) {
+#ifdef _WIN32
+	return 0 != MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+	return 0 == rename(from, to);
+#endif
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+	if (nullptr != data) {
+		UnmapViewOfFile(data);
+	}
+	if (nullptr != mappingHandle) {
+		CloseHandle(mappingHandle);
+	}
+	if (INVALID_HANDLE_VALUE != fileHandle) {
+		CloseHandle(fileHandle);
+	}
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = nullptr;
+#else
+	if (nullptr != data) {
+		munmap(const_cast<void *>(data), size);
+	}
+#endif
+	data = nullptr;
+	size = 0;
+	writable = false;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#ifndef SOBOL_KERNELS_H
+#define SOBOL_KERNELS_H
+
+#include <cstdint>
+
+// Inner loops of the batched Sobol generation. Every kernel works across the dimensions of one point, the
+// implementation (scalar, SSE2 or AVX2) is picked once at runtime from the features of the running CPU.
+// The uint64_t overloads convert with the 53 high bits, see SobolWord<uint64_t>.
+namespace SobolKernels {
+	// x[i] ^= v[i]
+	void Xor(uint32_t *x, const uint32_t *v, unsigned int n);
+	void Xor(uint64_t *x, const uint64_t *v, unsigned int n);
+	// out[i] = x[i] / 2^32
+	void ToUnit(const uint32_t *x, double *out, unsigned int n);
+	void ToUnit(const uint64_t *x, double *out, unsigned int n);
+	// x[i] ^= v[i], then out[i] = x[i] / 2^32
+	void XorToUnit(uint32_t *x, const uint32_t *v, double *out, unsigned int n);
+	void XorToUnit(uint64_t *x, const uint64_t *v, double *out, unsigned int n);
+	// out[i] = x[i] / 2^32 in single precision, from the 24 high bits so that it is exact and below 1
+	void ToFloat(const uint32_t *x, float *out, unsigned int n);
+	void ToFloat(const uint64_t *x, float *out, unsigned int n);
+	// out[i] = floor(x[i] / 2^32 * resolutions[i]), the cell of x[i] on a grid of at most 65536 cells. The
+	// uint64_t overload uses the 32 high bits.
+	void ToGrid(const uint32_t *x, const uint32_t *resolutions, uint16_t *out, unsigned int n);
+	void ToGrid(const uint64_t *x, const uint32_t *resolutions, uint16_t *out, unsigned int n);
+	// out[i] = (x[i] ^ keys[i]) / 2^32, a digital shift
+	void ShiftToUnit(const uint32_t *x, const uint32_t *keys, double *out, unsigned int n);
+	void ShiftToUnit(const uint64_t *x, const uint64_t *keys, double *out, unsigned int n);
+	// out[i] = OwenScramble(x[i], keys[i]) / 2^32. Only the uint32_t overload is vectorized, there is no 64 bit
+	// multiply before AVX-512.
+	void OwenToUnit(const uint32_t *x, const uint32_t *keys, double *out, unsigned int n);
+	void OwenToUnit(const uint64_t *x, const uint64_t *keys, double *out, unsigned int n);
+
+	inline uint32_t ReverseBits(uint32_t x) {
+		x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+		x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+		x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+		x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+		return (x >> 16) | (x << 16);
+	}
+
+	inline uint64_t ReverseBits(uint64_t x) {
+		return (uint64_t)ReverseBits((uint32_t)x) << 32 | ReverseBits((uint32_t)(x >> 32));
+	}
+
+	// Nested uniform (Owen) scrambling of one value with the hash of Burley, "Practical Hash-based Owen Scrambling"
+	// (2020). On the reversed bits every step only carries upwards, so each output bit is a random flip of the input
+	// bit keyed by all the bits above it, which is exactly an Owen scrambling. The 64 bit variant runs the same
+	// steps with 64 bit constants.
+	inline uint32_t OwenScramble(uint32_t x, uint32_t seed) {
+		x = ReverseBits(x);
+		x ^= x * 0x3d20adeau;
+		x += seed;
+		x *= (seed >> 16) | 1;
+		x ^= x * 0x05526c56u;
+		x ^= x * 0x53a22864u;
+		return ReverseBits(x);
+	}
+
+	inline uint64_t OwenScramble(uint64_t x, uint64_t seed) {
+		x = ReverseBits(x);
+		x ^= x * 0x9e3779b97f4a7c16u;
+		x += seed;
+		x *= (seed >> 32) | 1;
+		x ^= x * 0xbf58476d1ce4e5b8u;
+		x ^= x * 0x94d049bb133111eau;
+		return ReverseBits(x);
+	}
+
+	// Name of the selected implementation, "avx2", "sse2" or "scalar".
+	const char *Name();
+}
+
+#endif //SOBOL_KERNELS_H
\ No newline at end of file